@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <string.h>
 #include <cstdint>
+#include <math.h>
 
 /** All alphanumeric characters except for "0", "I", "O", and "l" */
 static const char* pszBase58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
@@ -123,6 +124,210 @@ std::string EncodeBase58(const unsigned char* pbegin, const unsigned char* pend)
 
 }
 
+// 58^5, the largest power of 58 below 2^32
+#define B58_CHUNK 656356768U
+
+// Fixed width encoding: the payload is loaded in NLIMB big endian 32 bits
+// limbs and divided by 58^5, each division gives 5 digits instead of one
+// carry loop per input byte. NLIMB is a constant so loops are unrolled.
+template<int NLIMB> static int encodeFixed(const unsigned char* p, int size, char* out) {
+
+  uint32_t limbs[NLIMB];
+  unsigned char bytes[4 * NLIMB];
+  unsigned char digits[6 * NLIMB];
+
+  memset(bytes, 0, 4 * NLIMB - size);
+  memcpy(bytes + 4 * NLIMB - size, p, size);
+  for (int i = 0; i < NLIMB; i++)
+    limbs[i] = ((uint32_t)bytes[4 * i] << 24) | ((uint32_t)bytes[4 * i + 1] << 16) |
+               ((uint32_t)bytes[4 * i + 2] << 8) | (uint32_t)bytes[4 * i + 3];
+
+  int zeroes = 0;
+  while (zeroes < size && p[zeroes] == 0)
+    zeroes++;
+
+  // Least significant digits first
+  int first = 0;
+  while (first < NLIMB && limbs[first] == 0)
+    first++;
+  int digitslen = 0;
+  while (first < NLIMB) {
+    uint64_t rem = 0;
+    for (int i = first; i < NLIMB; i++) {
+      uint64_t cur = (rem << 32) | limbs[i];
+      limbs[i] = (uint32_t)(cur / B58_CHUNK);
+      rem = cur % B58_CHUNK;
+    }
+    while (first < NLIMB && limbs[first] == 0)
+      first++;
+    uint32_t r = (uint32_t)rem;
+    for (int j = 0; j < 5; j++) {
+      digits[digitslen++] = (unsigned char)(r % 58);
+      r /= 58;
+    }
+  }
+  while (digitslen > 0 && digits[digitslen - 1] == 0)
+    digitslen--;
+
+  char* o = out;
+  for (int i = 0; i < zeroes; i++)
+    *o++ = '1';
+  for (int i = digitslen - 1; i >= 0; i--)
+    *o++ = pszBase58[digits[i]];
+  *o = 0;
+
+  return (int)(o - out);
+
+}
+
+int EncodeBase58(const unsigned char* pbegin, const unsigned char* pend, char* out) {
+
+  int size = (int)(pend - pbegin);
+  switch (size) {
+  case 25:
+    return encodeFixed<7>(pbegin, size, out);
+  case 37:
+  case 38:
+    return encodeFixed<10>(pbegin, size, out);
+  default:
+    if (size < 0 || size > 40)
+      return -1;
+    return encodeFixed<10>(pbegin, size, out);
+  }
+
+}
+
+// Powers of 58 below 2^224 (7 big endian limbs) and their approximation
+struct Base58Powers {
+
+  uint32_t p[40][7];
+  double inv[40];   // 1/58^e
+  double scale[8];  // Weight of a 3 limbs window starting at a limb
+  int nbPow;
+
+  Base58Powers() {
+    memset(p, 0, sizeof(p));
+    p[0][6] = 1;
+    double d = 1.0;
+    inv[0] = 1.0;
+    for (int t = 0; t < 8; t++)
+      scale[t] = ldexp(1.0, 32 * (4 - t));
+    nbPow = 1;
+    for (int e = 1; e < 40; e++) {
+      uint64_t carry = 0;
+      for (int i = 6; i >= 0; i--) {
+        carry += (uint64_t)p[e - 1][i] * 58;
+        p[e][i] = (uint32_t)carry;
+        carry >>= 32;
+      }
+      if (carry)
+        break;
+      d *= 58.0;
+      inv[e] = 1.0 / d;
+      nbPow++;
+    }
+  }
+
+};
+
+static const Base58Powers &base58Powers() {
+  static const Base58Powers pw;
+  return pw;
+}
+
+static inline int cmpLimbs(const uint32_t* a, const uint32_t* b) {
+  for (int i = 0; i < 7; i++)
+    if (a[i] != b[i])
+      return (a[i] < b[i]) ? -1 : 1;
+  return 0;
+}
+
+void Base58Leading::Set(const unsigned char* payload) {
+
+  const Base58Powers &pw = base58Powers();
+
+  r[0] = payload[0];
+  for (int i = 0; i < 6; i++)
+    r[i + 1] = ((uint32_t)payload[1 + 4 * i] << 24) | ((uint32_t)payload[2 + 4 * i] << 16) |
+               ((uint32_t)payload[3 + 4 * i] << 8) | (uint32_t)payload[4 + 4 * i];
+
+  zeroes = 0;
+  while (zeroes < 25 && payload[zeroes] == 0)
+    zeroes++;
+
+  top = 0;
+  while (top < 7 && r[top] == 0)
+    top++;
+
+  // Number of digits (a 25 bytes payload is below 58^35)
+  exp = 34;
+  while (exp >= 0 && cmpLimbs(r, pw.p[exp]) < 0)
+    exp--;
+
+}
+
+char Base58Leading::Next() {
+
+  if (zeroes > 0) {
+    zeroes--;
+    return '1';
+  }
+  if (exp < 0)
+    return 0;
+
+  const Base58Powers &pw = base58Powers();
+  const uint32_t* p = pw.p[exp];
+
+  // Estimate the digit on the 3 most significant limbs (at most one off)
+  double rd = 0.0;
+  for (int i = top; i < top + 3; i++)
+    rd = rd * 4294967296.0 + ((i < 7) ? (double)r[i] : 0.0);
+  int d = (int)(rd * pw.scale[top] * pw.inv[exp]);
+  if (d > 57) d = 57;
+
+  if (d > 0) {
+
+    // r -= d.58^exp on the limbs in use (one more for the estimation error)
+    int lo = (top > 0) ? top - 1 : 0;
+    uint64_t mc = 0;
+    int64_t borrow = 0;
+    for (int i = 6; i >= lo; i--) {
+      mc += (uint64_t)p[i] * (uint64_t)d;
+      int64_t v = (int64_t)r[i] - (int64_t)(uint32_t)mc + borrow;
+      mc >>= 32;
+      r[i] = (uint32_t)v;
+      borrow = v >> 32;
+    }
+    if (borrow < 0) {
+      // One too many, add back 58^exp
+      uint64_t c = 0;
+      for (int i = 6; i >= lo; i--) {
+        c += (uint64_t)r[i] + p[i];
+        r[i] = (uint32_t)c;
+        c >>= 32;
+      }
+      d--;
+    }
+
+  }
+
+  if (cmpLimbs(r, p) >= 0) {
+    int64_t b = 0;
+    for (int i = 6; i >= 0; i--) {
+      int64_t v = (int64_t)r[i] - (int64_t)p[i] + b;
+      r[i] = (uint32_t)v;
+      b = v >> 32;
+    }
+    d++;
+  }
+
+  while (top < 7 && r[top] == 0)
+    top++;
+  exp--;
+  return pszBase58[d];
+
+}
+
 std::string EncodeBase58(const std::vector<unsigned char>& vch)
 {
     return EncodeBase58(vch.data(), vch.data() + vch.size());
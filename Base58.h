@@ -20,6 +20,7 @@
 
 #include <string>
 #include <vector>
+#include <stdint.h>
 
 /**
  * Encode a byte sequence as a base58-encoded string.
@@ -27,6 +28,38 @@
  */
 std::string EncodeBase58(const unsigned char* pbegin, const unsigned char* pend);
 
+/**
+ * Encode a byte sequence into a caller buffer, null terminated, no allocation.
+ * Specialized for the 25 bytes address and 37/38 bytes WIF payloads, any size
+ * up to 40 bytes is accepted (out must hold 56 chars).
+ * return the length of the encoded string or -1 if the input is too long.
+ */
+int EncodeBase58(const unsigned char* pbegin, const unsigned char* pend, char* out);
+
+/**
+ * Incremental encoding of a 25 bytes payload, most significant digit first.
+ * Each digit costs one estimated division of the remainder by a power of 58,
+ * a pattern test can stop at the first mismatching character instead of
+ * converting the whole address.
+ */
+class Base58Leading {
+
+public:
+
+  void Set(const unsigned char* payload);
+
+  // Next character of the encoding, 0 when it is complete
+  char Next();
+
+private:
+
+  uint32_t r[7];  // Remainder, big endian limbs
+  int top;        // First non zero limb of the remainder
+  int zeroes;     // Leading '1' still to output
+  int exp;        // Power of 58 of the next digit, -1 when done
+
+};
+
 /**
  * Encode a byte vector as a base58-encoded string
  */
@@ -0,0 +1,219 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Base58Range.h"
+#include "SECP256k1.h"
+#include <math.h>
+#include <ctype.h>
+#include <algorithm>
+
+using namespace std;
+
+static const char *pszBase58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// ----------------------------------------------------------------------------
+
+static void powInt(Int &r, uint64_t b, int e) {
+
+  r.SetInt32(1);
+  for (int i = 0; i < e; i++)
+    r.Mult(b);
+
+}
+
+// r = v.2^n (ShiftL() is not safe for multiples of 64)
+static void setPow2(Int &r, uint64_t v, int n) {
+
+  r.SetInt32(0);
+  r.bits64[n / 64] = v << (n % 64);
+
+}
+
+// hash160 of a payload (payload - version.2^192) >> 32
+static void toHash160(Int &payload, Int &vMin, uint8_t *h) {
+
+  Int t(&payload);
+  t.Sub(&vMin);
+  t.ShiftR(32);
+  for (int i = 0; i < 20; i++)
+    h[i] = t.GetByte(19 - i);
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool Base58Range::Compile(const char *prefix, int length, int addrType, vector<HASH160_RANGE> &ranges,
+                          bool caseSensitive) {
+
+  ranges.clear();
+
+  int version;
+  switch (addrType) {
+  case P2PKH: version = 0x00; break;
+  case P2SH:  version = 0x05; break;
+  default:    return false;
+  }
+
+  // Leading '1' are leading zero bytes of the payload
+  int z = 0;
+  while (z < length && prefix[z] == '1')
+    z++;
+  if ((version == 0 && z == 0) || (version != 0 && z > 0) || z > 21)
+    return false;
+
+  const char *s = prefix + z;
+  int m = length - z;
+
+  // Digit classes, a letter matches both cases when case unsensitive
+  vector< vector<int> > classes(m);
+  for (int i = 0; i < m; i++) {
+    char c[2] = { s[i], s[i] };
+    if (!caseSensitive) {
+      c[0] = (char)tolower(s[i]);
+      c[1] = (char)toupper(s[i]);
+    }
+    for (int j = 0; j < 2; j++) {
+      const char *d = (c[j] != 0) ? strchr(pszBase58, c[j]) : NULL;
+      if (d != NULL && (classes[i].empty() || classes[i].back() != (int)(d - pszBase58)))
+        classes[i].push_back((int)(d - pszBase58));
+    }
+    if (classes[i].empty())
+      return false;
+    sort(classes[i].begin(), classes[i].end());
+  }
+
+  // Payloads of this version
+  Int vMin;
+  setPow2(vMin, version, 192);
+  Int vMax;
+  setPow2(vMax, version + 1, 192);
+  vMax.SubOne();
+
+  // Exactly z leading zero bytes (at least z if the prefix is only '1')
+  Int lo;
+  Int hi;
+  if (m > 0)
+    setPow2(lo, 1, 8 * (24 - z));
+  else
+    lo.SetInt32(0);
+  setPow2(hi, 1, 8 * (25 - z));
+  hi.SubOne();
+  if (lo.IsLower(&vMin)) lo.Set(&vMin);
+  if (hi.IsGreater(&vMax)) hi.Set(&vMax);
+  if (lo.IsGreater(&hi))
+    return false;
+
+  vector<HASH160_RANGE> all;
+  if (m == 0) {
+
+    HASH160_RANGE r;
+    toHash160(lo, vMin, r.lo);
+    toHash160(hi, vMin, r.hi);
+    all.push_back(r);
+
+  } else {
+
+    // The first positions are enumerated (at most MAX_EXPANSION combinations),
+    // the others are bounded by their lowest and highest digit
+    int nbFixed = 0;
+    int nbComb = 1;
+    while (nbFixed < m && nbComb * (int)classes[nbFixed].size() <= MAX_EXPANSION)
+      nbComb *= (int)classes[nbFixed++].size();
+
+    for (int c = 0; c < nbComb; c++) {
+
+      Int vLo;
+      Int vHi;
+      vLo.SetInt32(0);
+      vHi.SetInt32(0);
+      int cc = c;
+      for (int i = 0; i < m; i++) {
+        int dLo;
+        int dHi;
+        if (i < nbFixed) {
+          dLo = dHi = classes[i][cc % classes[i].size()];
+          cc /= (int)classes[i].size();
+        } else {
+          dLo = classes[i].front();
+          dHi = classes[i].back();
+        }
+        vLo.Mult(58);
+        vLo.Add((uint64_t)dLo);
+        vHi.Mult(58);
+        vHi.Add((uint64_t)dHi);
+      }
+      vHi.AddOne();
+
+      // s[0] != '1' so vLo.58^(L-m) has exactly L digits
+      for (int L = m; L <= 35; L++) {
+        Int p;
+        powInt(p, 58, L - m);
+        Int a(&vLo);
+        a.Mult(&p);
+        Int b(&vHi);
+        b.Mult(&p);
+        b.SubOne();
+        if (a.IsGreater(&hi))
+          break;
+        if (b.IsLower(&lo))
+          continue;
+        if (a.IsLower(&lo)) a.Set(&lo);
+        if (b.IsGreater(&hi)) b.Set(&hi);
+        HASH160_RANGE r;
+        toHash160(a, vMin, r.lo);
+        toHash160(b, vMin, r.hi);
+        all.push_back(r);
+      }
+
+    }
+
+  }
+
+  // Sorted and disjoint, touching intervals are merged
+  sort(all.begin(), all.end(), [](const HASH160_RANGE &a, const HASH160_RANGE &b) {
+    return memcmp(a.lo, b.lo, 20) < 0;
+  });
+  for (size_t i = 0; i < all.size(); i++) {
+    if (ranges.size() && memcmp(all[i].lo, ranges.back().hi, 20) <= 0) {
+      if (memcmp(all[i].hi, ranges.back().hi, 20) > 0)
+        memcpy(ranges.back().hi, all[i].hi, 20);
+    } else {
+      ranges.push_back(all[i]);
+    }
+  }
+
+  return ranges.size() > 0;
+
+}
+
+// ----------------------------------------------------------------------------
+
+double Base58Range::Width(const vector<HASH160_RANGE> &ranges) {
+
+  double w = 0.0;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    double lo = 0.0;
+    double hi = 0.0;
+    for (int j = 0; j < 20; j++) {
+      lo = lo * 256.0 + ranges[i].lo[j];
+      hi = hi * 256.0 + ranges[i].hi[j];
+    }
+    w += hi - lo + 1.0;
+  }
+  return w;
+
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BASE58RANGEH
+#define BASE58RANGEH
+
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+// Inclusive hash160 interval (big endian)
+typedef struct {
+
+  uint8_t lo[20];
+  uint8_t hi[20];
+
+} HASH160_RANGE;
+
+// A P2PKH or P2SH base58 prefix is the set of 25 bytes payloads whose
+// encoding starts with it, that is one numeric interval per address length.
+// Dropping the checksum gives a few hash160 intervals, a candidate is then
+// matched with two 160 bits comparisons instead of a base58 encoding.
+// The checksum is unknown so hash160 at an interval bound may still encode
+// to another prefix, hits must be confirmed on the encoded address.
+// A case unsensitive prefix is compiled without expanding its 2^n spellings:
+// the first letters are enumerated up to MAX_EXPANSION combinations and the
+// remaining ones are bounded by their lowest and highest case, the few
+// extra hits are rejected by the confirmation.
+#define MAX_EXPANSION 64
+
+class Base58Range {
+
+public:
+
+  // Compile a base58 prefix, return false if it cannot be an address of addrType
+  static bool Compile(const char *prefix, int length, int addrType, std::vector<HASH160_RANGE> &ranges,
+                      bool caseSensitive = true);
+
+  // Number of hash160 covered by the ranges (as a double)
+  static double Width(const std::vector<HASH160_RANGE> &ranges);
+
+  // Ranges are sorted and disjoint
+  static inline bool Match(const HASH160_RANGE *ranges, int nbRange, const uint8_t *h) {
+
+    int st = 0;
+    int ed = nbRange;
+    while (st < ed) {
+      int mi = (st + ed) / 2;
+      if (memcmp(h, ranges[mi].lo, 20) < 0) ed = mi;
+      else st = mi + 1;
+    }
+    return st > 0 && memcmp(h, ranges[st - 1].hi, 20) <= 0;
+
+  }
+
+};
+
+#endif // BASE58RANGEH
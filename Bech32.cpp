@@ -25,6 +25,13 @@
 
 #include "Bech32.h"
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 uint32_t bech32_polymod_step(uint32_t pre) {
   uint8_t b = pre >> 25;
   return ((pre & 0x1FFFFFF) << 5) ^
@@ -93,6 +100,134 @@ int bech32_encode_data(char *output, const char *hrp, const uint8_t *bytes, size
   return bech32_encode(output, hrp, data, data_len);
 }
 
+// Nostr npub: hrp "npub", 52 data symbols (256 bits + 4 padding bits), 6 checksum symbols.
+// The checksum is linear over GF(32): it is the checksum of the hrp and an all
+// zero data part, xored with the contribution of each (position, symbol) pair.
+// Contributions are tabulated once, so the 58 sequential polymod steps become
+// 52 independent table loads.
+#define NPUB_DATA_LENGTH 52
+
+static struct NpubTables {
+
+  uint32_t base;
+  uint32_t pos[NPUB_DATA_LENGTH][32];
+
+  NpubTables() {
+
+    uint32_t chk = 1;
+    const char *hrp = "npub";
+    for (int i = 0; hrp[i]; i++) chk = bech32_polymod_step(chk) ^ (hrp[i] >> 5);
+    chk = bech32_polymod_step(chk);
+    for (int i = 0; hrp[i]; i++) chk = bech32_polymod_step(chk) ^ (hrp[i] & 0x1f);
+    for (int i = 0; i < NPUB_DATA_LENGTH + 6; i++) chk = bech32_polymod_step(chk);
+    base = chk ^ 1;
+
+    for (int p = 0; p < NPUB_DATA_LENGTH; p++) {
+      for (uint32_t v = 0; v < 32; v++) {
+        uint32_t c = v;
+        for (int i = p + 1; i < NPUB_DATA_LENGTH + 6; i++) c = bech32_polymod_step(c);
+        pos[p][v] = c;
+      }
+    }
+
+  }
+
+} npubTables;
+
+static inline uint64_t loadBE40(const uint8_t *b) {
+  return ((uint64_t)b[0] << 32) | ((uint64_t)b[1] << 24) | ((uint64_t)b[2] << 16) |
+         ((uint64_t)b[3] << 8) | (uint64_t)b[4];
+}
+
+// 8->5 regrouping, 5 bytes give 8 symbols (one pdep with BMI2)
+static inline void npub_symbols(const uint8_t *x, uint8_t *d) {
+
+  for (int c = 0; c < 6; c++) {
+    uint64_t v = loadBE40(x + 5 * c);
+#if defined(__BMI2__)
+    uint64_t s = __builtin_bswap64(_pdep_u64(v, 0x1F1F1F1F1F1F1F1FULL));
+    memcpy(d + 8 * c, &s, 8);
+#else
+    for (int j = 0; j < 8; j++)
+      d[8 * c + j] = (uint8_t)((v >> (35 - 5 * j)) & 0x1f);
+#endif
+  }
+  d[48] = x[30] >> 3;
+  d[49] = ((x[30] & 0x07) << 2) | (x[31] >> 6);
+  d[50] = (x[31] >> 1) & 0x1f;
+  d[51] = (x[31] & 0x01) << 4;
+
+}
+
+static inline uint32_t npub_checksum(const uint8_t *d) {
+
+  uint32_t c0 = npubTables.base;
+  uint32_t c1 = 0;
+  for (int i = 0; i < NPUB_DATA_LENGTH; i += 2) {
+    c0 ^= npubTables.pos[i][d[i]];
+    c1 ^= npubTables.pos[i + 1][d[i + 1]];
+  }
+  return c0 ^ c1;
+
+}
+
+// Map 64 symbols (0..31) to the bech32 charset
+static inline void npub_charset(const uint8_t *d, char *s) {
+
+#if defined(__SSSE3__)
+  const __m128i lo = _mm_loadu_si128((const __m128i *)charset);
+  const __m128i hi = _mm_loadu_si128((const __m128i *)(charset + 16));
+  const __m128i f = _mm_set1_epi8(15);
+  for (int i = 0; i < 64; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(d + i));
+    __m128i m = _mm_cmpgt_epi8(v, f);
+    __m128i r = _mm_or_si128(_mm_and_si128(m, _mm_shuffle_epi8(hi, v)),
+                             _mm_andnot_si128(m, _mm_shuffle_epi8(lo, v)));
+    _mm_storeu_si128((__m128i *)(s + i), r);
+  }
+#else
+  for (int i = 0; i < 64; i++)
+    s[i] = charset[d[i]];
+#endif
+
+}
+
+void npub_encode_batch(char *const *output, const uint8_t *const *x, int n) {
+
+  uint8_t d[NPUB_BATCH_MAX][64];
+  char s[64];
+
+  while (n > 0) {
+
+    int nb = (n < NPUB_BATCH_MAX) ? n : NPUB_BATCH_MAX;
+
+    for (int k = 0; k < nb; k++) {
+      npub_symbols(x[k], d[k]);
+      uint32_t chk = npub_checksum(d[k]);
+      for (int i = 0; i < 6; i++)
+        d[k][NPUB_DATA_LENGTH + i] = (chk >> ((5 - i) * 5)) & 0x1f;
+      memset(d[k] + NPUB_DATA_LENGTH + 6, 0, 64 - NPUB_DATA_LENGTH - 6);
+    }
+
+    for (int k = 0; k < nb; k++) {
+      npub_charset(d[k], s);
+      memcpy(output[k], "npub1", 5);
+      memcpy(output[k] + 5, s, NPUB_DATA_LENGTH + 6);
+      output[k][NPUB_LENGTH] = 0;
+    }
+
+    output += nb;
+    x += nb;
+    n -= nb;
+
+  }
+
+}
+
+void npub_encode(char *output, const uint8_t *x) {
+  npub_encode_batch(&output, &x, 1);
+}
+
 int bech32_decode_nocheck(uint8_t *data, size_t *data_len, const char *input) {
 
   uint8_t acc=0;
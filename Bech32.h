@@ -89,6 +89,19 @@ int bech32_encode_data(
   size_t bytes_len
 );
 
+/** Encode Nostr npub strings (table driven checksum, no intermediate buffer)
+ *
+ *  Out: output:  Pointers to n buffers of at least NPUB_LENGTH + 1 bytes.
+ *  In:  x:       Pointers to n 32 bytes big endian X-only public keys.
+ *       n:       Number of keys, processed by groups of NPUB_BATCH_MAX.
+ */
+#define NPUB_LENGTH 63
+#define NPUB_BATCH_MAX 8
+
+void npub_encode_batch(char *const *output, const uint8_t *const *x, int n);
+
+void npub_encode(char *output, const uint8_t *x);
+
 /** Decode a Bech32 string
  *
  *  Out: hrp:      Pointer to a buffer of size strlen(input) - 6. Will be
@@ -0,0 +1,116 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Bech32Pattern.h"
+
+static const char *charset = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+static const char *hrp = "bc1q";
+
+// ----------------------------------------------------------------------------
+
+bool Bech32Pattern::Compile(const char *pattern, int length, bool isPrefix, HASH160_MASK &m) {
+
+  memset(&m, 0, sizeof(m));
+
+  bool star = isPrefix;
+  int i = 0;
+
+  // Human readable part, separator and witness version 0
+  for (; i < 4 && i < length; i++) {
+    if (pattern[i] == '*') {
+      star = true;
+      break;
+    }
+    if (pattern[i] != '?' && pattern[i] != hrp[i])
+      return false;
+  }
+
+  // Data part
+  for (; i < 36 && i < length && pattern[i] != '*'; i++) {
+    if (pattern[i] == '?')
+      continue;
+    const char *d = (pattern[i] != 0) ? strchr(charset, pattern[i]) : NULL;
+    if (d == NULL)
+      return false;
+    int v = (int)(d - charset);
+    int pos = 5 * (i - 4);
+    for (int b = 0; b < 5; b++, pos++) {
+      m.mask[pos / 8] |= (uint8_t)(0x80 >> (pos % 8));
+      if (v & (0x10 >> b))
+        m.value[pos / 8] |= (uint8_t)(0x80 >> (pos % 8));
+    }
+  }
+
+  // Checksum, only validated
+  for (; i < length; i++) {
+    if (pattern[i] == '*')
+      star = true;
+    else if (pattern[i] != '?' && (pattern[i] == 0 || strchr(charset, pattern[i]) == NULL))
+      return false;
+  }
+
+  // Without '*' the whole address is given
+  return star || length == 42;
+
+}
+
+// ----------------------------------------------------------------------------
+
+int Bech32Pattern::NbBit(const HASH160_MASK &m) {
+
+  int n = 0;
+  for (int i = 0; i < 20; i++)
+    for (int b = 0; b < 8; b++)
+      n += (m.mask[i] >> b) & 1;
+  return n;
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool Bech32Pattern::ToRange(const HASH160_MASK &m, HASH160_RANGE &r) {
+
+  // Fixed bits must be the leading ones
+  bool free = false;
+  for (int i = 0; i < 20; i++) {
+    for (int b = 7; b >= 0; b--) {
+      bool fixed = (m.mask[i] >> b) & 1;
+      if (fixed && free)
+        return false;
+      free |= !fixed;
+    }
+    r.lo[i] = m.value[i];
+    r.hi[i] = m.value[i] | (uint8_t)~m.mask[i];
+  }
+  return true;
+
+}
+
+// ----------------------------------------------------------------------------
+
+void Bech32Pattern::GetPrefixes(const HASH160_MASK &m, std::vector<uint16_t> &prefixes) {
+
+  prefixes.clear();
+  for (int i = 0; i < 65536; i++) {
+    uint8_t b[2];
+    uint16_t p = (uint16_t)i;
+    memcpy(b, &p, 2);
+    if ((b[0] & m.mask[0]) == m.value[0] && (b[1] & m.mask[1]) == m.value[1])
+      prefixes.push_back(p);
+  }
+
+}
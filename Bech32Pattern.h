@@ -0,0 +1,70 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BECH32PATTERNH
+#define BECH32PATTERNH
+
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+#include "Base58Range.h"
+
+// hash160 bits fixed by a pattern (big endian, as the hash160 bytes)
+typedef struct {
+
+  uint8_t mask[20];
+  uint8_t value[20];
+
+} HASH160_MASK;
+
+// A bc1q (P2WPKH) address is "bc1q", 32 data characters holding the 160
+// bits of the hash160 (5 bits each, most significant first) and a 6
+// characters checksum. Data characters of a prefix or of a pattern up to its
+// first '*' are thus a mask and value on the hash160, a candidate is matched
+// with three word comparisons instead of a segwit encoding.
+// '?' leaves its 5 bits free, checksum characters and everything after the
+// first '*' are not compiled, hits must be confirmed on the encoded address.
+class Bech32Pattern {
+
+public:
+
+  // Compile a pattern (a prefix if isPrefix), return false if it cannot match a bc1q address
+  static bool Compile(const char *pattern, int length, bool isPrefix, HASH160_MASK &m);
+
+  // Number of fixed bits
+  static int NbBit(const HASH160_MASK &m);
+
+  // A prefix mask is one hash160 interval
+  static bool ToRange(const HASH160_MASK &m, HASH160_RANGE &r);
+
+  // 16 bits lookup prefixes (read in native order from the hash160) allowed by the mask
+  static void GetPrefixes(const HASH160_MASK &m, std::vector<uint16_t> &prefixes);
+
+  static inline bool Match(const HASH160_MASK &m, const uint8_t *h) {
+
+    uint64_t h0, h1, m0, m1, v0, v1;
+    uint32_t h2, m2, v2;
+    memcpy(&h0, h, 8); memcpy(&h1, h + 8, 8); memcpy(&h2, h + 16, 4);
+    memcpy(&m0, m.mask, 8); memcpy(&m1, m.mask + 8, 8); memcpy(&m2, m.mask + 16, 4);
+    memcpy(&v0, m.value, 8); memcpy(&v1, m.value + 8, 8); memcpy(&v2, m.value + 16, 4);
+    return ((h0 & m0) == v0) & ((h1 & m1) == v1) & ((h2 & m2) == v2);
+
+  }
+
+};
+
+#endif // BECH32PATTERNH
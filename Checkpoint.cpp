@@ -0,0 +1,119 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Checkpoint.h"
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef WIN64
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char checkpointMagic[8] = { 'V','S','C','H','E','C','K','P' };
+
+// ----------------------------------------------------------------------------
+
+bool Checkpoint::Save(string fileName, CHECKPOINT_HEADER &h, vector<KEY_RANGE> &ranges, vector<uint8_t> &flags) {
+
+  memcpy(h.magic, checkpointMagic, 8);
+  h.version = CHECKPOINT_VERSION;
+  h.headerSize = sizeof(CHECKPOINT_HEADER);
+  h.nbRange = ranges.size();
+  h.nbFlag = flags.size();
+
+  // Written and synced before the rename, a killed job always leaves the
+  // previous or the new checkpoint
+  string tmpName = fileName + ".tmp";
+  FILE *f = fopen(tmpName.c_str(), "wb");
+  if (f == NULL) {
+    printf("Warning: Cannot write checkpoint %s %s\n", tmpName.c_str(), strerror(errno));
+    return false;
+  }
+
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  if (ranges.size())
+    ok &= fwrite(ranges.data(), sizeof(KEY_RANGE), ranges.size(), f) == ranges.size();
+  if (flags.size())
+    ok &= fwrite(flags.data(), 1, flags.size(), f) == flags.size();
+  ok &= fflush(f) == 0;
+#ifdef WIN64
+  ok &= _commit(_fileno(f)) == 0;
+#else
+  ok &= fsync(fileno(f)) == 0;
+#endif
+  ok &= fclose(f) == 0;
+
+#ifdef WIN64
+  ok = ok && MoveFileExA(tmpName.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+  ok = ok && rename(tmpName.c_str(), fileName.c_str()) == 0;
+#endif
+
+  if (!ok) {
+    printf("Warning: Cannot write checkpoint %s %s\n", fileName.c_str(), strerror(errno));
+    remove(tmpName.c_str());
+    return false;
+  }
+
+  return true;
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool Checkpoint::Load(string fileName, uint8_t key[32], CHECKPOINT_HEADER &h, vector<KEY_RANGE> &ranges,
+                      vector<uint8_t> &flags) {
+
+  FILE *f = fopen(fileName.c_str(), "rb");
+  if (f == NULL)
+    return false;
+
+  fseek(f, 0, SEEK_END);
+  uint64_t size = (uint64_t)ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  bool ok = fread(&h, sizeof(h), 1, f) == 1 && memcmp(h.magic, checkpointMagic, 8) == 0 &&
+            h.version == CHECKPOINT_VERSION && h.headerSize == sizeof(CHECKPOINT_HEADER) &&
+            size == sizeof(h) + h.nbRange * sizeof(KEY_RANGE) + h.nbFlag;
+  if (ok) {
+    ranges.resize(h.nbRange);
+    flags.resize(h.nbFlag);
+    if (h.nbRange)
+      ok &= fread(ranges.data(), sizeof(KEY_RANGE), h.nbRange, f) == h.nbRange;
+    if (h.nbFlag)
+      ok &= fread(flags.data(), 1, h.nbFlag, f) == h.nbFlag;
+  }
+  fclose(f);
+
+  if (!ok) {
+    printf("Error: %s is not a valid checkpoint\n", fileName.c_str());
+    exit(-1);
+  }
+  if (memcmp(h.key, key, 32) != 0) {
+    printf("Error: %s was written for another search (input or options differ)\n", fileName.c_str());
+    exit(-1);
+  }
+
+  return true;
+
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHECKPOINTH
+#define CHECKPOINTH
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "KeyScheduler.h"
+
+#define CHECKPOINT_VERSION 2  // 2: chunks of 36864 keys
+#define CHECKPOINT_INTERVAL 60.0  // Seconds
+
+// Search position, written to a temporary file then renamed
+// File layout:
+//   CHECKPOINT_HEADER
+//   KEY_RANGE[nbRange]   Walked chunks (sorted, merged)
+//   uint8_t[nbFlag]      Found flags (patterns, targets, prefixes)
+
+typedef struct {
+
+  char     magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint8_t  key[32];        // Hash of the input and search options
+  uint64_t baseKey[4];     // First key of chunk 0
+  uint64_t keyEnd[4];      // End of the keyspace (bounded search)
+  uint64_t nbChunk;        // Chunks of the keyspace, KEY_UNBOUNDED if endless
+  uint64_t nbKey;          // Keys checked
+  uint64_t nbRange;
+  uint64_t nbFlag;
+  int32_t  nbFound;
+  int32_t  zeroBest;
+  uint32_t bounded;
+  uint32_t reserved;
+
+} CHECKPOINT_HEADER;
+
+class Checkpoint {
+
+public:
+
+  // magic, version, headerSize, nbRange and nbFlag are set by Save()
+  static bool Save(std::string fileName, CHECKPOINT_HEADER &h, std::vector<KEY_RANGE> &ranges,
+                   std::vector<uint8_t> &flags);
+
+  // Return false if the file does not exist, exit if it is invalid or
+  // written for another search
+  static bool Load(std::string fileName, uint8_t key[32], CHECKPOINT_HEADER &h, std::vector<KEY_RANGE> &ranges,
+                   std::vector<uint8_t> &flags);
+
+};
+
+#endif // CHECKPOINTH
@@ -0,0 +1,179 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CpuTopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#ifdef WIN64
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#define MAX_NODE 64
+
+// ----------------------------------------------------------------------------
+
+#if defined(__linux__)
+
+static int readInt(const char *path, int def) {
+
+  FILE *f = fopen(path, "r");
+  if (f == NULL)
+    return def;
+  int v;
+  if (fscanf(f, "%d", &v) != 1)
+    v = def;
+  fclose(f);
+  return v;
+
+}
+
+// "0-3,8-11" list format
+static vector<int> readList(const char *path) {
+
+  vector<int> l;
+  FILE *f = fopen(path, "r");
+  if (f == NULL)
+    return l;
+  char buff[4096];
+  if (fgets(buff, sizeof(buff), f) != NULL) {
+    char *s = buff;
+    while (*s >= '0' && *s <= '9') {
+      int st = (int)strtol(s, &s, 10);
+      int ed = st;
+      if (*s == '-')
+        ed = (int)strtol(s + 1, &s, 10);
+      for (int i = st; i <= ed; i++)
+        l.push_back(i);
+      if (*s == ',') s++;
+    }
+  }
+  fclose(f);
+  return l;
+
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+CpuTopology::CpuTopology() {
+
+  nbNode = 1;
+
+#if defined(__linux__)
+
+  char path[256];
+  vector<int> online = readList("/sys/devices/system/cpu/online");
+  for (int i = 0; i < (int)online.size(); i++) {
+    CPU_ITEM c;
+    c.cpu = online[i];
+    sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/core_id", c.cpu);
+    c.core = readInt(path, c.cpu);
+    sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c.cpu);
+    c.package = readInt(path, 0);
+    c.node = 0;
+    c.smt = 0;
+    cpus.push_back(c);
+  }
+
+  for (int n = 0; n < MAX_NODE; n++) {
+    sprintf(path, "/sys/devices/system/node/node%d/cpulist", n);
+    vector<int> l = readList(path);
+    for (int i = 0; i < (int)l.size(); i++) {
+      for (int j = 0; j < (int)cpus.size(); j++) {
+        if (cpus[j].cpu == l[i]) {
+          cpus[j].node = n;
+          nbNode = max(nbNode, n + 1);
+        }
+      }
+    }
+  }
+
+#endif
+
+  if (cpus.empty()) {
+#ifdef WIN64
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    int nbCpu = (int)si.dwNumberOfProcessors;
+#else
+    int nbCpu = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    for (int i = 0; i < max(nbCpu, 1); i++) {
+      CPU_ITEM c = { i, i, 0, 0, 0 };
+      cpus.push_back(c);
+    }
+  }
+
+  // Sibling rank, by logical CPU number inside a core
+  for (int i = 0; i < (int)cpus.size(); i++)
+    for (int j = 0; j < (int)cpus.size(); j++)
+      if (cpus[j].package == cpus[i].package && cpus[j].core == cpus[i].core && cpus[j].cpu < cpus[i].cpu)
+        cpus[i].smt++;
+
+}
+
+// ----------------------------------------------------------------------------
+
+vector<CPU_ITEM> CpuTopology::Layout(int mode) {
+
+  vector<CPU_ITEM> l = cpus;
+
+  if (mode == PIN_SMT) {
+    sort(l.begin(), l.end(), [](const CPU_ITEM &a, const CPU_ITEM &b) {
+      if (a.node != b.node) return a.node < b.node;
+      if (a.package != b.package) return a.package < b.package;
+      if (a.core != b.core) return a.core < b.core;
+      return a.smt < b.smt;
+    });
+  } else {
+    sort(l.begin(), l.end(), [](const CPU_ITEM &a, const CPU_ITEM &b) {
+      if (a.smt != b.smt) return a.smt < b.smt;
+      if (a.node != b.node) return a.node < b.node;
+      if (a.package != b.package) return a.package < b.package;
+      return a.core < b.core;
+    });
+  }
+  return l;
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool CpuTopology::Pin(int cpu) {
+
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(WIN64)
+  if (cpu >= 64)
+    return false;
+  return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+  return false;
+#endif
+
+}
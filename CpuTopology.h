@@ -0,0 +1,58 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CPUTOPOLOGYH
+#define CPUTOPOLOGYH
+
+#include <vector>
+
+// CPU thread placement (-pin option)
+#define PIN_NONE  0
+#define PIN_CORES 1  // One thread per physical core, SMT siblings once all cores are used
+#define PIN_SMT   2  // SMT siblings of a core get consecutive threads
+
+typedef struct {
+
+  int cpu;      // Logical CPU
+  int core;     // Physical core id (in its package)
+  int package;
+  int node;     // NUMA node
+  int smt;      // Rank among the siblings of the core
+
+} CPU_ITEM;
+
+// Logical CPUs read from /sys on Linux, other systems are seen as one
+// node of independent cores. Threads are pinned on the layout order and
+// allocate their state once pinned, the first touch keeps it on their node.
+class CpuTopology {
+
+public:
+
+  CpuTopology();
+
+  // Logical CPUs in the order threads are placed
+  std::vector<CPU_ITEM> Layout(int mode);
+
+  // Pin the calling thread, return false if not supported
+  static bool Pin(int cpu);
+
+  std::vector<CPU_ITEM> cpus;
+  int nbNode;
+
+};
+
+#endif // CPUTOPOLOGYH
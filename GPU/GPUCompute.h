@@ -44,8 +44,6 @@ __device__ __noinline__ void CheckPoint(uint32_t *_h, int32_t incr, int32_t endo
   prefix_t   pr0;
   prefix_t   hit;
   uint32_t   pos;
-  uint32_t   st;
-  uint32_t   ed;
   uint32_t   mi;
   uint32_t   lmi;
   uint32_t   tid = (blockIdx.x*blockDim.x) + threadIdx.x;
@@ -70,21 +68,18 @@ __device__ __noinline__ void CheckPoint(uint32_t *_h, int32_t incr, int32_t endo
     if (hit) {
 
       if (lookup32) {
+        // Buckets are stored in Eytzinger order (see PrefixLookup.h)
         off = lookup32[pr0];
         l32 = _h[0];
-        st = off;
-        ed = off + hit - 1;
-        while (st <= ed) {
-          mi = (st + ed) / 2;
-          lmi = lookup32[mi];
-          if (l32 < lmi) {
-            ed = mi - 1;
-          } else if (l32 == lmi) {
-            // found
-            goto addItem;
-          } else {
-            st = mi + 1;
-          }
+        mi = 1;
+        while (mi <= hit) {
+          lmi = lookup32[off + mi - 1];
+          mi = 2 * mi + (lmi < l32);
+        }
+        mi >>= __ffs(~mi);
+        if (mi && lookup32[off + mi - 1] == l32) {
+          // found
+          goto addItem;
         }
         return;
       }
@@ -350,8 +345,64 @@ __device__ __noinline__ void CheckNpubPrefix(uint64_t *px, int32_t incr, int32_t
   }
 }
 
+// Hex x-only public key patterns (NOSTR_HEX), pattern[0] is the number of
+// patterns followed by their X mask and value limbs (least significant first)
+__device__ __noinline__ void CheckHexPattern(uint64_t *px, int32_t incr, int32_t endo, uint32_t maxFound, uint32_t *out, const uint64_t *pattern) {
+  uint32_t nb = (uint32_t)pattern[0];
+  const uint64_t *m = pattern + 1;
+  for (uint32_t i = 0; i < nb; i++, m += 8) {
+    if (((px[0] & m[0]) ^ m[4]) | ((px[1] & m[1]) ^ m[5]) | ((px[2] & m[2]) ^ m[6]) | ((px[3] & m[3]) ^ m[7]))
+      continue;
+    uint32_t tid = (blockIdx.x*blockDim.x) + threadIdx.x;
+    uint32_t pos = atomicAdd(out, 1);
+    if (pos < maxFound) {
+      out[pos*ITEM_SIZE32 + 1] = tid;
+      out[pos*ITEM_SIZE32 + 2] = (uint32_t)(incr << 16) | (uint32_t)(1 << 15) | (uint32_t)(endo);
+      out[pos*ITEM_SIZE32 + 3] = 0;
+      out[pos*ITEM_SIZE32 + 4] = 0;
+      out[pos*ITEM_SIZE32 + 5] = 0;
+      out[pos*ITEM_SIZE32 + 6] = 0;
+      out[pos*ITEM_SIZE32 + 7] = 0;
+    }
+    return;
+  }
+}
+
+// Leading zero bits (NOSTR_HEX with -lz), pattern is the X limit (limbs
+// least significant first), X < limit has the requested leading zero bits.
+// The top limb comparison rejects almost every candidate.
+__device__ __noinline__ void CheckZeroBits(uint64_t *px, int32_t incr, int32_t endo, uint32_t maxFound, uint32_t *out, const uint64_t *limit) {
+  int i = 3;
+  while (i >= 0 && px[i] == limit[i])
+    i--;
+  if (i < 0 || px[i] > limit[i])
+    return;
+  uint32_t tid = (blockIdx.x*blockDim.x) + threadIdx.x;
+  uint32_t pos = atomicAdd(out, 1);
+  if (pos < maxFound) {
+    out[pos*ITEM_SIZE32 + 1] = tid;
+    out[pos*ITEM_SIZE32 + 2] = (uint32_t)(incr << 16) | (uint32_t)(1 << 15) | (uint32_t)(endo);
+    out[pos*ITEM_SIZE32 + 3] = 0;
+    out[pos*ITEM_SIZE32 + 4] = 0;
+    out[pos*ITEM_SIZE32 + 5] = 0;
+    out[pos*ITEM_SIZE32 + 6] = 0;
+    out[pos*ITEM_SIZE32 + 7] = 0;
+  }
+}
+
+#define NOSTR_KIND_NPUB 0
+#define NOSTR_KIND_HEX  1
+#define NOSTR_KIND_ZERO 2
+
+#define CHECK_NOSTR(x, incr, endo)                                                                  \
+  if (kind == NOSTR_KIND_ZERO) CheckZeroBits(x, incr, endo, maxFound, out, (const uint64_t *)pattern); \
+  else if (kind == NOSTR_KIND_HEX) CheckHexPattern(x, incr, endo, maxFound, out, (const uint64_t *)pattern); \
+  else CheckNpubPrefix(x, incr, endo, maxFound, out, (const char *)pattern)
+
+// x-only walk shared by the npub, hex and leading zero bits searches
+template<int kind>
 __device__ void ComputeKeysNostrPattern(uint64_t *startx, uint64_t *starty,
-                             const char *pattern, uint32_t maxFound, uint32_t *out) {
+                             const void *pattern, uint32_t maxFound, uint32_t *out) {
 
   uint64_t dx[GRP_SIZE/2+1][4];
   uint64_t px[4];
@@ -388,9 +439,9 @@ __device__ void ComputeKeysNostrPattern(uint64_t *startx, uint64_t *starty,
     // base point
     _ModMult(pe1x, px, _beta);
     _ModMult(pe2x, px, _beta2);
-    CheckNpubPrefix(px,  j*GRP_SIZE + (GRP_SIZE/2), 0, maxFound, out, pattern);
-    CheckNpubPrefix(pe1x, j*GRP_SIZE + (GRP_SIZE/2), 1, maxFound, out, pattern);
-    CheckNpubPrefix(pe2x, j*GRP_SIZE + (GRP_SIZE/2), 2, maxFound, out, pattern);
+    CHECK_NOSTR(px, j*GRP_SIZE + (GRP_SIZE/2), 0);
+    CHECK_NOSTR(pe1x, j*GRP_SIZE + (GRP_SIZE/2), 1);
+    CHECK_NOSTR(pe2x, j*GRP_SIZE + (GRP_SIZE/2), 2);
 
     ModNeg256(pyn,py);
 
@@ -410,9 +461,9 @@ __device__ void ComputeKeysNostrPattern(uint64_t *startx, uint64_t *starty,
 
       _ModMult(pe1x, px, _beta);
       _ModMult(pe2x, px, _beta2);
-      CheckNpubPrefix(px,  j*GRP_SIZE + (GRP_SIZE/2 + (i + 1)), 0, maxFound, out, pattern);
-      CheckNpubPrefix(pe1x, j*GRP_SIZE + (GRP_SIZE/2 + (i + 1)), 1, maxFound, out, pattern);
-      CheckNpubPrefix(pe2x, j*GRP_SIZE + (GRP_SIZE/2 + (i + 1)), 2, maxFound, out, pattern);
+      CHECK_NOSTR(px, j*GRP_SIZE + (GRP_SIZE/2 + (i + 1)), 0);
+      CHECK_NOSTR(pe1x, j*GRP_SIZE + (GRP_SIZE/2 + (i + 1)), 1);
+      CHECK_NOSTR(pe2x, j*GRP_SIZE + (GRP_SIZE/2 + (i + 1)), 2);
 
       __syncthreads();
       // P = StartPoint - i*G, if (x,y) = i*G then (x,-y) = -i*G
@@ -427,9 +478,9 @@ __device__ void ComputeKeysNostrPattern(uint64_t *startx, uint64_t *starty,
 
       _ModMult(pe1x, px, _beta);
       _ModMult(pe2x, px, _beta2);
-      CheckNpubPrefix(px,  j*GRP_SIZE + (GRP_SIZE/2 - (i + 1)), 0, maxFound, out, pattern);
-      CheckNpubPrefix(pe1x, j*GRP_SIZE + (GRP_SIZE/2 - (i + 1)), 1, maxFound, out, pattern);
-      CheckNpubPrefix(pe2x, j*GRP_SIZE + (GRP_SIZE/2 - (i + 1)), 2, maxFound, out, pattern);
+      CHECK_NOSTR(px, j*GRP_SIZE + (GRP_SIZE/2 - (i + 1)), 0);
+      CHECK_NOSTR(pe1x, j*GRP_SIZE + (GRP_SIZE/2 - (i + 1)), 1);
+      CHECK_NOSTR(pe2x, j*GRP_SIZE + (GRP_SIZE/2 - (i + 1)), 2);
 
     }
 
@@ -448,9 +499,9 @@ __device__ void ComputeKeysNostrPattern(uint64_t *startx, uint64_t *starty,
 
     _ModMult(pe1x, px, _beta);
     _ModMult(pe2x, px, _beta2);
-    CheckNpubPrefix(px,  j*GRP_SIZE + (0), 0, maxFound, out, pattern);
-    CheckNpubPrefix(pe1x, j*GRP_SIZE + (0), 1, maxFound, out, pattern);
-    CheckNpubPrefix(pe2x, j*GRP_SIZE + (0), 2, maxFound, out, pattern);
+    CHECK_NOSTR(px, j*GRP_SIZE + (0), 0);
+    CHECK_NOSTR(pe1x, j*GRP_SIZE + (0), 1);
+    CHECK_NOSTR(pe2x, j*GRP_SIZE + (0), 2);
 
     i++;
 
@@ -81,7 +81,19 @@ __global__ void comp_keys_p2sh_pattern(uint32_t mode, prefix_t *pattern, uint64_
 __global__ void comp_keys_nostr_pattern(uint64_t *keys, uint32_t maxFound, uint32_t *found, const char *pattern) {
   int xPtr = (blockIdx.x*blockDim.x) * 8;
   int yPtr = xPtr + 4 * blockDim.x;
-  ComputeKeysNostrPattern(keys + xPtr, keys + yPtr, (const char *)pattern, maxFound, found);
+  ComputeKeysNostrPattern<NOSTR_KIND_NPUB>(keys + xPtr, keys + yPtr, pattern, maxFound, found);
+}
+
+__global__ void comp_keys_nostr_hex(uint64_t *keys, uint32_t maxFound, uint32_t *found, const uint64_t *pattern) {
+  int xPtr = (blockIdx.x*blockDim.x) * 8;
+  int yPtr = xPtr + 4 * blockDim.x;
+  ComputeKeysNostrPattern<NOSTR_KIND_HEX>(keys + xPtr, keys + yPtr, pattern, maxFound, found);
+}
+
+__global__ void comp_keys_nostr_zero(uint64_t *keys, uint32_t maxFound, uint32_t *found, const uint64_t *limit) {
+  int xPtr = (blockIdx.x*blockDim.x) * 8;
+  int yPtr = xPtr + 4 * blockDim.x;
+  ComputeKeysNostrPattern<NOSTR_KIND_ZERO>(keys + xPtr, keys + yPtr, limit, maxFound, found);
 }
 
 //#define FULLCHECK
@@ -290,6 +302,7 @@ GPUEngine::GPUEngine(int nbThreadGroup, int nbThreadPerGroup, int gpuId, uint32_
   initialised = true;
   pattern = "";
   hasPattern = false;
+  zeroBits = 0;
   inputPrefixLookUp = NULL;
 
 }
@@ -410,6 +423,56 @@ void GPUEngine::SetPattern(const char *pattern) {
 
 }
 
+void GPUEngine::SetHexPattern(const uint64_t *masks, int nbMask) {
+
+  // Pattern count then mask and value limbs of each pattern
+  uint64_t *p = (uint64_t *)inputPrefixPinned;
+  p[0] = (uint64_t)nbMask;
+  memcpy(p + 1, masks, nbMask * 64);
+
+  // Fill device memory
+  cudaMemcpy(inputPrefix, inputPrefixPinned, _64K * 2, cudaMemcpyHostToDevice);
+
+  // We do not need the input pinned memory anymore
+  cudaFreeHost(inputPrefixPinned);
+  inputPrefixPinned = NULL;
+  lostWarning = false;
+
+  cudaError_t err = cudaGetLastError();
+  if (err != cudaSuccess) {
+    printf("GPUEngine: SetHexPattern: %s\n", cudaGetErrorString(err));
+  }
+
+  hasPattern = true;
+
+}
+
+void GPUEngine::SetZeroBits(int nbBit) {
+
+  // X < 2^(256-nbBit)
+  uint64_t *limit = (uint64_t *)inputPrefixPinned;
+  memset(limit, 0, 32);
+  int b = 256 - nbBit;
+  limit[b / 64] = 1ULL << (b % 64);
+
+  // Fill device memory
+  cudaMemcpy(inputPrefix, inputPrefixPinned, _64K * 2, cudaMemcpyHostToDevice);
+
+  // We do not need the input pinned memory anymore
+  cudaFreeHost(inputPrefixPinned);
+  inputPrefixPinned = NULL;
+  lostWarning = false;
+
+  cudaError_t err = cudaGetLastError();
+  if (err != cudaSuccess) {
+    printf("GPUEngine: SetZeroBits: %s\n", cudaGetErrorString(err));
+  }
+
+  hasPattern = true;
+  zeroBits = nbBit;
+
+}
+
 void GPUEngine::SetPrefix(std::vector<LPREFIX> prefixes, uint32_t totalPrefix) {
 
   // Allocate memory for the second level of lookup tables
@@ -431,6 +494,7 @@ void GPUEngine::SetPrefix(std::vector<LPREFIX> prefixes, uint32_t totalPrefix) {
     int nbLPrefix = (int)prefixes[i].lPrefixes.size();
     inputPrefixPinned[prefixes[i].sPrefix] = (uint16_t)nbLPrefix;
     inputPrefixLookUpPinned[prefixes[i].sPrefix] = offset;
+    // Bucket is copied as is (Eytzinger order, built by the host)
     for (int j = 0; j < nbLPrefix; j++) {
       inputPrefixLookUpPinned[offset++]=prefixes[i].lPrefixes[j];
     }
@@ -477,13 +541,18 @@ bool GPUEngine::callKernel() {
 
   } else {
 
-    // P2PKH or BECH32 or NOSTR_NPUB
+    // P2PKH or BECH32 or NOSTR_NPUB or NOSTR_HEX
     if (hasPattern) {
       if (searchType == BECH32) {
-        printf("GPUEngine: (TODO) BECH32 not yet supported with wildard\n");
+        // bc1q patterns are compiled to hash160 masks, use SetPrefix()
+        printf("GPUEngine: BECH32 patterns must be set as prefixes\n");
         return false;
       }
-      if (searchType == NOSTR_NPUB) {
+      if (searchType == NOSTR_HEX && zeroBits > 0) {
+        comp_keys_nostr_zero <<< nbThread / nbThreadPerGroup, nbThreadPerGroup >>> (inputKey, maxFound, outputPrefix, (const uint64_t *)inputPrefix);
+      } else if (searchType == NOSTR_HEX) {
+        comp_keys_nostr_hex <<< nbThread / nbThreadPerGroup, nbThreadPerGroup >>> (inputKey, maxFound, outputPrefix, (const uint64_t *)inputPrefix);
+      } else if (searchType == NOSTR_NPUB) {
         comp_keys_nostr_pattern <<< nbThread / nbThreadPerGroup, nbThreadPerGroup >>> (inputKey, maxFound, outputPrefix, (const char *)inputPrefix);
       } else {
         comp_keys_pattern <<< nbThread / nbThreadPerGroup, nbThreadPerGroup >>> (searchMode, inputPrefix, inputKey, maxFound, outputPrefix);
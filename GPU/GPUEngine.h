@@ -35,6 +35,9 @@ static const char *searchModes[] = {"Compressed","Uncompressed","Compressed or U
 #define ITEM_SIZE32 (ITEM_SIZE/4)
 #define _64K 65536
 
+// Hex patterns fitting in the 64K prefix table (count + 64 bytes per pattern)
+#define GPU_HEX_MAX_PATTERN ((_64K * 2 - 8) / 64)
+
 typedef uint16_t prefix_t;
 typedef uint32_t prefixl_t;
 
@@ -64,6 +67,8 @@ public:
   void SetSearchMode(int searchMode);
   void SetSearchType(int searchType);
   void SetPattern(const char *pattern);
+  void SetHexPattern(const uint64_t *masks, int nbMask);
+  void SetZeroBits(int nbBit);
   bool Launch(std::vector<ITEM> &prefixFound,bool spinWait=false);
   int GetNbThread();
   int GetGroupSize();
@@ -101,6 +106,7 @@ private:
   uint32_t outputSize;
   std::string pattern;
   bool hasPattern;
+  int zeroBits;
 
 };
 
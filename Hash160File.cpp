@@ -0,0 +1,278 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Hash160File.h"
+#include "PrefixFile.h"
+#include "SECP256k1.h"
+#include "Base58.h"
+#include "Bech32.h"
+#include "Timer.h"
+#include "hash/sha256.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#ifndef WIN64
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char hash160Magic[8] = { 'V','S','H','A','S','H','1','6' };
+
+typedef struct {
+  uint8_t h[20];
+} HASH160;
+
+static bool operator<(const HASH160 &a, const HASH160 &b) { return memcmp(a.h, b.h, 20) < 0; }
+static bool operator==(const HASH160 &a, const HASH160 &b) { return memcmp(a.h, b.h, 20) == 0; }
+
+// ----------------------------------------------------------------------------
+
+Hash160File::Hash160File(const string &fileName) {
+
+  double t0 = Timer::get_tick();
+
+#ifndef WIN64
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    printf("Error: Cannot open %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    printf("Error: Cannot stat %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  size = (size_t)st.st_size;
+  if (size < sizeof(HASH160_HEADER)) {
+    printf("Error: %s is not a hash160 list\n", fileName.c_str());
+    exit(-1);
+  }
+  map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    printf("Error: Cannot map %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+
+#else
+
+  FILE *fp = fopen(fileName.c_str(), "rb");
+  if (fp == NULL) {
+    printf("Error: Cannot open %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  _fseeki64(fp, 0, SEEK_END);
+  size = (size_t)_ftelli64(fp);
+  _fseeki64(fp, 0, SEEK_SET);
+  if (size < sizeof(HASH160_HEADER)) {
+    printf("Error: %s is not a hash160 list\n", fileName.c_str());
+    exit(-1);
+  }
+  map = malloc(size);
+  if (fread(map, 1, size, fp) != size) {
+    printf("Error: Cannot read %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  fclose(fp);
+
+#endif
+
+  HASH160_HEADER *h = (HASH160_HEADER *)map;
+  if (memcmp(h->magic, hash160Magic, 8) != 0) {
+    printf("Error: %s is not a hash160 list\n", fileName.c_str());
+    exit(-1);
+  }
+  if (h->version != HASH160_VERSION) {
+    printf("Error: %s wrong version %u (expected %u)\n", fileName.c_str(), h->version, HASH160_VERSION);
+    exit(-1);
+  }
+  if (h->addrType != P2PKH && h->addrType != P2SH && h->addrType != BECH32) {
+    printf("Error: %s unexpected address type %d\n", fileName.c_str(), h->addrType);
+    exit(-1);
+  }
+  if (size != sizeof(HASH160_HEADER) + h->nbHash * 20) {
+    printf("Error: %s truncated file\n", fileName.c_str());
+    exit(-1);
+  }
+
+  addrType = h->addrType;
+  nbHash = h->nbHash;
+  hashes = (const uint8_t *)map + sizeof(HASH160_HEADER);
+
+  // Bucket offsets (the list must be sorted)
+  uint32_t b = 0;
+  offsets[0] = 0;
+  for (uint64_t i = 0; i < nbHash; i++) {
+    const uint8_t *hi = hashes + i * 20;
+    if (i > 0 && memcmp(hi - 20, hi, 20) >= 0) {
+      printf("Error: %s is not sorted (record %llu)\n", fileName.c_str(), (unsigned long long)i);
+      exit(-1);
+    }
+    uint32_t bi = ((uint32_t)hi[0] << 8) | hi[1];
+    while (b < bi) offsets[++b] = i;
+  }
+  while (b < 65536) offsets[++b] = nbHash;
+
+  found = (uint8_t *)calloc(nbHash + 1, 1);
+  nbFound = 0;
+
+  double t1 = Timer::get_tick();
+  printf("[Loading hash160 list] %llu hash160 in %.3f s\n", (unsigned long long)nbHash, t1 - t0);
+
+}
+
+// ----------------------------------------------------------------------------
+
+Hash160File::~Hash160File() {
+
+#ifndef WIN64
+  munmap(map, size);
+#else
+  free(map);
+#endif
+  free(found);
+
+}
+
+// ----------------------------------------------------------------------------
+
+// Decode an address to its hash160, return its type or -1
+static int decodeAddress(const char *addr, int length, uint8_t *h160) {
+
+  char a[128];
+  if (length <= 0 || length >= (int)sizeof(a))
+    return -1;
+  memcpy(a, addr, length);
+  a[length] = 0;
+
+  if (a[0] == '1' || a[0] == '3') {
+
+    vector<unsigned char> r;
+    if (!DecodeBase58(a, r) || r.size() != 25)
+      return -1;
+    uint8_t d1[32];
+    uint8_t d2[32];
+    sha256(r.data(), 21, d1);
+    sha256(d1, 32, d2);
+    if (memcmp(d2, r.data() + 21, 4) != 0)
+      return -1;
+    if (r[0] != 0x00 && r[0] != 0x05)
+      return -1;
+    memcpy(h160, r.data() + 1, 20);
+    return (r[0] == 0x00) ? P2PKH : P2SH;
+
+  } else if (length > 4 && (strncmp(a, "bc1q", 4) == 0)) {
+
+    int ver;
+    uint8_t prog[40];
+    size_t progLength;
+    if (!segwit_addr_decode(&ver, prog, &progLength, "bc", a) || ver != 0 || progLength != 20)
+      return -1;
+    memcpy(h160, prog, 20);
+    return BECH32;
+
+  }
+
+  return -1;
+
+}
+
+void Hash160File::Convert(const string &inFile, const string &outFile) {
+
+  int nbThread = Timer::getCoreNumber();
+  PrefixFile in(inFile, nbThread);
+
+  double t0 = Timer::get_tick();
+
+  vector< vector<HASH160> > slices(nbThread);
+  vector<int> sliceType(nbThread, -1);
+  vector<uint64_t> sliceError(nbThread, 0);
+
+  int nbSlice = PrefixFile::ParallelFor(in.lines.size(), nbThread, [&](int t, size_t first, size_t last) {
+    slices[t].reserve(last - first);
+    for (size_t i = first; i < last; i++) {
+      HASH160 h;
+      int type = decodeAddress(in.lines[i].str, (int)in.lines[i].length, h.h);
+      if (type < 0 || (sliceType[t] >= 0 && type != sliceType[t])) {
+        sliceError[t]++;
+        continue;
+      }
+      sliceType[t] = type;
+      slices[t].push_back(h);
+    }
+  });
+
+  // All addresses must have the same type
+  int addrType = -1;
+  uint64_t nbError = 0;
+  vector<HASH160> all;
+  for (int t = 0; t < nbSlice; t++) {
+    nbError += sliceError[t];
+    if (sliceType[t] < 0)
+      continue;
+    if (addrType >= 0 && sliceType[t] != addrType) {
+      printf("Error: %s mixes several address types\n", inFile.c_str());
+      exit(-1);
+    }
+    addrType = sliceType[t];
+    all.insert(all.end(), slices[t].begin(), slices[t].end());
+    vector<HASH160>().swap(slices[t]);
+  }
+
+  if (addrType < 0) {
+    printf("Error: no valid address found in %s\n", inFile.c_str());
+    exit(-1);
+  }
+
+  sort(all.begin(), all.end());
+  all.erase(unique(all.begin(), all.end()), all.end());
+
+  HASH160_HEADER h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, hash160Magic, 8);
+  h.version = HASH160_VERSION;
+  h.addrType = addrType;
+  h.nbHash = all.size();
+
+  FILE *f = fopen(outFile.c_str(), "wb");
+  if (f == NULL) {
+    printf("Error: Cannot open %s %s\n", outFile.c_str(), strerror(errno));
+    exit(-1);
+  }
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  if (all.size())
+    ok &= fwrite(all.data(), 20, all.size(), f) == all.size();
+  ok &= fclose(f) == 0;
+  if (!ok) {
+    printf("Error: Cannot write %s %s\n", outFile.c_str(), strerror(errno));
+    exit(-1);
+  }
+
+  double t1 = Timer::get_tick();
+  printf("%s: %llu hash160 written (%llu invalid or duplicate lines skipped) in %.3f s\n", outFile.c_str(),
+    (unsigned long long)all.size(), (unsigned long long)(in.lines.size() - all.size()), t1 - t0);
+  if (nbError)
+    printf("Warning: %llu line(s) could not be decoded\n", (unsigned long long)nbError);
+
+}
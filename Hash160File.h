@@ -0,0 +1,80 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HASH160FILEH
+#define HASH160FILEH
+
+#include <string>
+#include <stdint.h>
+#include <string.h>
+
+#define HASH160_VERSION 1
+
+// Binary target list (-ih option)
+// A HASH160_HEADER followed by nbHash sorted and unique 20 bytes hash160.
+typedef struct {
+
+  char     magic[8];
+  uint32_t version;
+  int32_t  addrType;     // P2PKH, P2SH or BECH32
+  uint64_t nbHash;
+
+} HASH160_HEADER;
+
+class Hash160File {
+
+public:
+
+  // Map a binary list, exit on error
+  Hash160File(const std::string &fileName);
+  ~Hash160File();
+
+  // Convert a text file of addresses into a binary list
+  static void Convert(const std::string &inFile, const std::string &outFile);
+
+  // Search hash160, return its index or -1
+  inline int64_t Find(const uint8_t *h) {
+
+    uint32_t b = ((uint32_t)h[0] << 8) | h[1];
+    uint64_t st = offsets[b];
+    uint64_t ed = offsets[b + 1];
+    while (st < ed) {
+      uint64_t mi = (st + ed) / 2;
+      int c = memcmp(h, hashes + mi * 20, 20);
+      if (c == 0) return (int64_t)mi;
+      if (c < 0) ed = mi;
+      else st = mi + 1;
+    }
+    return -1;
+
+  }
+
+  const uint8_t *hashes;
+  uint64_t nbHash;
+  int addrType;
+  uint64_t offsets[65537];   // Bucket start, indexed by the 2 first bytes (big endian)
+  uint8_t *found;
+  uint64_t nbFound;
+
+private:
+
+  void *map;
+  size_t size;
+
+};
+
+#endif // HASH160FILEH
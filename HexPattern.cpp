@@ -0,0 +1,81 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "HexPattern.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+static int hexValue(char c) {
+
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+
+}
+
+// Nibble n of X (0 is the most significant one)
+static bool setNibble(XONLY_MASK &m, int n, char c) {
+
+  if (c == '?')
+    return true;
+  int v = hexValue(c);
+  if (v < 0)
+    return false;
+  int limb = 3 - n / 16;
+  int shift = 4 * (15 - n % 16);
+  m.mask[limb] |= 0xFULL << shift;
+  m.value[limb] |= (uint64_t)v << shift;
+  return true;
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool HexPattern::Compile(const char *pattern, int length, XONLY_MASK &m) {
+
+  memset(&m, 0, sizeof(m));
+
+  const char *star = (const char *)memchr(pattern, '*', length);
+  int prefixLength = star ? (int)(star - pattern) : length;
+  int suffixLength = star ? length - prefixLength - 1 : 0;
+  if (prefixLength + suffixLength > 64 || (star && memchr(star + 1, '*', suffixLength)))
+    return false;
+
+  for (int i = 0; i < prefixLength; i++)
+    if (!setNibble(m, i, pattern[i]))
+      return false;
+  for (int i = 0; i < suffixLength; i++)
+    if (!setNibble(m, 64 - suffixLength + i, star[1 + i]))
+      return false;
+
+  return NbBit(m) > 0;
+
+}
+
+// ----------------------------------------------------------------------------
+
+int HexPattern::NbBit(const XONLY_MASK &m) {
+
+  int n = 0;
+  for (int i = 0; i < 4; i++)
+    for (int b = 0; b < 64; b++)
+      n += (int)((m.mask[i] >> b) & 1);
+  return n;
+
+}
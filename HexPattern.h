@@ -0,0 +1,57 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEXPATTERNH
+#define HEXPATTERNH
+
+#include <stdint.h>
+
+// X bits fixed by a pattern (limbs least significant first, as Int::bits64)
+typedef struct {
+
+  uint64_t mask[4];
+  uint64_t value[4];
+
+} XONLY_MASK;
+
+// Hex x-only public key pattern (-hex option)
+// The hex public key shown by Nostr clients is X, 64 nibbles most
+// significant first, so a pattern is a mask and value on the X limbs and a
+// candidate is matched with four word comparisons, without any encoding.
+// '?' leaves its nibble free. Characters before a '*' are a prefix, the ones
+// after it are a suffix aligned on the last nibble (one '*' at most),
+// without '*' the pattern is a prefix.
+class HexPattern {
+
+public:
+
+  // Compile a pattern, return false if it is not a valid hex pattern
+  static bool Compile(const char *pattern, int length, XONLY_MASK &m);
+
+  // Number of fixed bits
+  static int NbBit(const XONLY_MASK &m);
+
+  static inline bool Match(const XONLY_MASK &m, const uint64_t *x) {
+
+    return (((x[0] & m.mask[0]) ^ m.value[0]) | ((x[1] & m.mask[1]) ^ m.value[1]) |
+            ((x[2] & m.mask[2]) ^ m.value[2]) | ((x[3] & m.mask[3]) ^ m.value[3])) == 0;
+
+  }
+
+};
+
+#endif // HEXPATTERNH
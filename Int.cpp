@@ -1212,7 +1212,39 @@ std::string Int::GetBase10() {
 // ------------------------------------------------
 
 std::string Int::GetBase16() {
-  return GetBaseN(16,"0123456789ABCDEF");
+  char out[BASE16_MAX_LENGTH];
+  GetBase16(out);
+  return std::string(out);
+}
+
+int Int::GetBase16(char *out) {
+
+  static const char *digits = "0123456789ABCDEF";
+
+  Int N(this);
+  char *o = out;
+  if (N.IsNegative()) {
+    N.Neg();
+    *o++ = '-';
+  }
+
+  // Same output as GetBaseN(), without leading zero
+  bool lead = true;
+  for (int i = NB64BLOCK * 8 - 1; i >= 0; i--) {
+    unsigned char b = N.GetByte(i);
+    if (lead && b == 0)
+      continue;
+    if (!lead || (b >> 4))
+      *o++ = digits[b >> 4];
+    *o++ = digits[b & 0xF];
+    lead = false;
+  }
+  if (lead)
+    *o++ = '0';
+  *o = 0;
+
+  return (int)(o - out);
+
 }
 
 // ------------------------------------------------
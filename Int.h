@@ -37,6 +37,9 @@
   #error Unsuported size
 #endif
 
+// Hex string with sign and null terminator
+#define BASE16_MAX_LENGTH (NB64BLOCK * 16 + 2)
+
 class Int {
 
 public:
@@ -171,6 +174,7 @@ public:
   std::string GetBase2();
   std::string GetBase10();
   std::string GetBase16();
+  int GetBase16(char *out); // No allocation, out must hold BASE16_MAX_LENGTH chars
   std::string GetBaseN(int n,char *charset);
   std::string GetBlockStr();
   std::string GetC64Str(int nbDigit);
@@ -797,10 +797,19 @@ void Int::SetupField(Int *n, Int *R, Int *R2, Int *R3, Int *R4) {
   
   // OPTIMIZATION: Use precomputed Montgomery constants for secp256k1
   // These are computed offline for the field FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F
-  _R.SetBase16("1000003D10000000400000000000000000000000000000000000000000000000");    // R = 2^256 mod p
-  _R2.SetBase16("E40B034C1F0000004800000000000000000000000000000000000000000000000");   // R^2 mod p  
-  _R3.SetBase16("48062A5C041F000068C0000000000000000000000000000000000000000000000");   // R^3 mod p
-  _R4.SetBase16("AAAFFE4000000030000000000000000000000000000000000000000000000000");   // R^4 mod p
+  Int secpP;
+  secpP.SetBase16("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F");
+  if (_P.IsEqual(&secpP)) {
+    _R.SetBase16("1000003D1");                                            // R = 2^256 mod p
+    _R2.SetBase16("1000007A2000E90A1");                                   // R^2 mod p
+    _R3.SetBase16("100000B73002BB1E33795F671");                           // R^3 mod p
+    _R4.SetBase16("100000F44005763C6DE57DA9823518541");                   // R^4 mod p
+  } else {
+    _R.ModInv();                     // R  = R
+    _R2.ModInv();                    // R2 = R^2
+    _R3.ModInv();                    // R3 = R^3
+    _R4.ModInv();                    // R4 = R^4
+  }
 
   if (R)
     R->Set(&_R);
@@ -0,0 +1,375 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KeyScheduler.h"
+#include <algorithm>
+
+using namespace std;
+
+// ----------------------------------------------------------------------------
+
+KeyScheduler::KeyScheduler() {
+
+  nbChunk = KEY_UNBOUNDED;
+  nbBlock = KEY_UNBOUNDED;
+  ranges = NULL;
+  nbWorker = 0;
+  gpuRanges = NULL;
+  nbGPU = 0;
+  nextBlock.store(0);
+  nbGap.store(0);
+
+#ifdef WIN64
+  doneMutex = CreateMutex(NULL, FALSE, NULL);
+#else
+  pthread_mutex_init(&doneMutex, NULL);
+#endif
+
+}
+
+KeyScheduler::~KeyScheduler() {
+
+  delete[] ranges;
+  delete[] gpuRanges;
+
+}
+
+// ----------------------------------------------------------------------------
+
+void KeyScheduler::Init(uint64_t nbChunk, int nbWorker, int nbGPU) {
+
+  this->nbChunk = nbChunk;
+  if (nbChunk == KEY_UNBOUNDED)
+    nbBlock = KEY_UNBOUNDED;
+  else
+    nbBlock = nbChunk / KEY_BLOCK_CHUNKS + ((nbChunk % KEY_BLOCK_CHUNKS) ? 1 : 0);
+
+  delete[] ranges;
+  this->nbWorker = nbWorker;
+  ranges = new WORKER_RANGE[nbWorker > 0 ? nbWorker : 1];
+  for (int i = 0; i < nbWorker; i++) {
+    ranges[i].start.store(0);
+    ranges[i].cur.store(0);
+    ranges[i].end.store(0);
+  }
+
+  delete[] gpuRanges;
+  this->nbGPU = nbGPU;
+  gpuRanges = new GPU_RANGE[nbGPU > 0 ? nbGPU : 1];
+  for (int i = 0; i < nbGPU; i++)
+    gpuRanges[i].walked.store(0);
+
+  nextBlock.store(0);
+  gaps.clear();
+  nbGap.store(0);
+  completed.clear();
+
+}
+
+void KeyScheduler::Restore(const vector<KEY_RANGE> &done) {
+
+  completed.clear();
+  for (int i = 0; i < (int)done.size(); i++)
+    if (done[i].start < min(done[i].end, nbChunk))
+      Insert(completed, { done[i].start, min(done[i].end, nbChunk) });
+
+  // Blocks up to the last walked chunk are not handed out again, their
+  // gaps are (cut at the block size)
+  uint64_t top = completed.empty() ? 0 : completed.back().end;
+  uint64_t next = top / KEY_BLOCK_CHUNKS + ((top % KEY_BLOCK_CHUNKS) ? 1 : 0);
+  uint64_t limit = min(next * KEY_BLOCK_CHUNKS, nbChunk);
+  nextBlock.store(next);
+
+  gaps.clear();
+  uint64_t s = 0;
+  for (int i = 0; i <= (int)completed.size(); i++) {
+    uint64_t e = (i < (int)completed.size()) ? completed[i].start : limit;
+    while (s < e) {
+      KEY_RANGE g = { s, min(e, s + KEY_BLOCK_CHUNKS) };
+      gaps.push_back(g);
+      s = g.end;
+    }
+    if (i < (int)completed.size())
+      s = completed[i].end;
+  }
+  nbGap.store((int)gaps.size());
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool KeyScheduler::GetGap(KEY_RANGE &r) {
+
+  if (nbGap.load() == 0)
+    return false;
+
+#ifdef WIN64
+  WaitForSingleObject(doneMutex, INFINITE);
+#else
+  pthread_mutex_lock(&doneMutex);
+#endif
+  bool ok = !gaps.empty();
+  if (ok) {
+    r = gaps.front();
+    gaps.erase(gaps.begin());
+    nbGap.store((int)gaps.size());
+  }
+#ifdef WIN64
+  ReleaseMutex(doneMutex);
+#else
+  pthread_mutex_unlock(&doneMutex);
+#endif
+  return ok;
+
+}
+
+int KeyScheduler::GetBlocks(uint64_t *starts, int n) {
+
+  // A GPU walks whole blocks, a gap is walked from its first chunk
+  int nb = 0;
+  KEY_RANGE g;
+  while (nb < n && GetGap(g))
+    starts[nb++] = g.start;
+  if (nb == n)
+    return nb;
+
+  uint64_t b = nextBlock.fetch_add((uint64_t)(n - nb));
+  while (nb < n && b < nbBlock) {
+    starts[nb++] = b * KEY_BLOCK_CHUNKS;
+    b++;
+  }
+  return nb;
+
+}
+
+bool KeyScheduler::Get(int w, uint64_t &start, uint64_t &end) {
+
+  KEY_RANGE g;
+  uint64_t b;
+  if (GetGap(g)) {
+    start = g.start;
+    end = g.end;
+  } else if ((b = nextBlock.fetch_add(1)) < nbBlock) {
+    start = b * KEY_BLOCK_CHUNKS;
+    end = min(start + KEY_BLOCK_CHUNKS, nbChunk);
+  } else if (!Steal(start, end)) {
+    start = end = 0;
+  }
+
+  // Published before walking, may be stolen from now (end cleared first so
+  // that a thief never sees the new chunk with the previous end). The lock
+  // keeps start and cur coherent for a checkpoint.
+#ifdef WIN64
+  WaitForSingleObject(doneMutex, INFINITE);
+#else
+  pthread_mutex_lock(&doneMutex);
+#endif
+  ranges[w].end.store(0);
+  ranges[w].start.store(start);
+  ranges[w].cur.store(start);
+  ranges[w].end.store(end);
+#ifdef WIN64
+  ReleaseMutex(doneMutex);
+#else
+  pthread_mutex_unlock(&doneMutex);
+#endif
+  return start < end;
+
+}
+
+bool KeyScheduler::Next(int w, uint64_t &c) {
+
+  c++;
+  ranges[w].cur.store(c);
+  return c < ranges[w].end.load();
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool KeyScheduler::Steal(uint64_t &start, uint64_t &end) {
+
+  for (;;) {
+
+    // Largest remainder (chunks after the one in progress)
+    int victim = -1;
+    uint64_t best = 1;
+    for (int i = 0; i < nbWorker; i++) {
+      uint64_t c = ranges[i].cur.load();
+      uint64_t e = ranges[i].end.load();
+      if (e > c + 1 && e - c - 1 > best) {
+        best = e - c - 1;
+        victim = i;
+      }
+    }
+    if (victim < 0)
+      return false;
+
+    uint64_t c = ranges[victim].cur.load();
+    uint64_t e = ranges[victim].end.load();
+    if (e <= c + 2)
+      continue;
+    uint64_t mid = c + 1 + (e - c - 1) / 2;
+    if (!ranges[victim].end.compare_exchange_strong(e, mid))
+      continue;
+
+    // The victim may be past mid, its current chunk is taken again as it
+    // may have read the new end before walking it
+    uint64_t y = ranges[victim].cur.load();
+    start = max(mid, y);
+    end = e;
+    if (start < end)
+      return true;
+
+  }
+
+}
+
+// ----------------------------------------------------------------------------
+
+void KeyScheduler::SetBlocks(int g, const uint64_t *starts, int n) {
+
+#ifdef WIN64
+  WaitForSingleObject(doneMutex, INFINITE);
+#else
+  pthread_mutex_lock(&doneMutex);
+#endif
+  gpuRanges[g].blocks.assign(starts, starts + n);
+  gpuRanges[g].walked.store(0);
+#ifdef WIN64
+  ReleaseMutex(doneMutex);
+#else
+  pthread_mutex_unlock(&doneMutex);
+#endif
+
+}
+
+void KeyScheduler::SetWalked(int g, uint64_t n) {
+
+  gpuRanges[g].walked.store(n);
+
+}
+
+// ----------------------------------------------------------------------------
+
+void KeyScheduler::Insert(vector<KEY_RANGE> &l, KEY_RANGE r) {
+
+  // Insert and merge with the touching or overlapping ranges
+  vector<KEY_RANGE>::iterator it = lower_bound(l.begin(), l.end(), r,
+    [](const KEY_RANGE &a, const KEY_RANGE &b) { return a.start < b.start; });
+  it = l.insert(it, r);
+  if (it != l.begin() && (it - 1)->end >= it->start) {
+    (it - 1)->end = max((it - 1)->end, it->end);
+    it = l.erase(it) - 1;
+  }
+  while (it + 1 != l.end() && (it + 1)->start <= it->end) {
+    it->end = max(it->end, (it + 1)->end);
+    l.erase(it + 1);
+  }
+
+}
+
+void KeyScheduler::Done(uint64_t start, uint64_t end) {
+
+  end = min(end, nbChunk);
+  if (start >= end)
+    return;
+
+#ifdef WIN64
+  WaitForSingleObject(doneMutex, INFINITE);
+#else
+  pthread_mutex_lock(&doneMutex);
+#endif
+
+  Insert(completed, { start, end });
+
+#ifdef WIN64
+  ReleaseMutex(doneMutex);
+#else
+  pthread_mutex_unlock(&doneMutex);
+#endif
+
+}
+
+vector<KEY_RANGE> KeyScheduler::GetCompleted() {
+
+#ifdef WIN64
+  WaitForSingleObject(doneMutex, INFINITE);
+  vector<KEY_RANGE> r = completed;
+  ReleaseMutex(doneMutex);
+#else
+  pthread_mutex_lock(&doneMutex);
+  vector<KEY_RANGE> r = completed;
+  pthread_mutex_unlock(&doneMutex);
+#endif
+  return r;
+
+}
+
+uint64_t KeyScheduler::GetNbCompleted() {
+
+  vector<KEY_RANGE> r = GetCompleted();
+  uint64_t nb = 0;
+  for (int i = 0; i < (int)r.size(); i++)
+    nb += r[i].end - r[i].start;
+  return nb;
+
+}
+
+uint64_t KeyScheduler::GetContiguous() {
+
+  vector<KEY_RANGE> r = GetCompleted();
+  return (r.size() && r[0].start == 0) ? r[0].end : 0;
+
+}
+
+vector<KEY_RANGE> KeyScheduler::GetCheckpoint() {
+
+#ifdef WIN64
+  WaitForSingleObject(doneMutex, INFINITE);
+#else
+  pthread_mutex_lock(&doneMutex);
+#endif
+
+  vector<KEY_RANGE> r = completed;
+
+  // Chunks before the one in progress
+  for (int i = 0; i < nbWorker; i++) {
+    uint64_t s = ranges[i].start.load();
+    uint64_t c = min(ranges[i].cur.load(), nbChunk);
+    if (s < c)
+      Insert(r, { s, c });
+  }
+
+  for (int i = 0; i < nbGPU; i++) {
+    uint64_t w = gpuRanges[i].walked.load();
+    for (int j = 0; j < (int)gpuRanges[i].blocks.size() && w > 0; j++) {
+      uint64_t s = gpuRanges[i].blocks[j];
+      uint64_t e = min(s + w, nbChunk);
+      if (s < e)
+        Insert(r, { s, e });
+    }
+  }
+
+#ifdef WIN64
+  ReleaseMutex(doneMutex);
+#else
+  pthread_mutex_unlock(&doneMutex);
+#endif
+  return r;
+
+}
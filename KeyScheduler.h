@@ -0,0 +1,132 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KEYSCHEDULERH
+#define KEYSCHEDULERH
+
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+#ifdef WIN64
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// The keyspace is cut in chunks of KEY_CHUNK_SIZE keys (a multiple of all
+// CPU group sizes and of the GPU step), chunk c starts at base key +
+// c.KEY_CHUNK_SIZE. Chunks are handed out by blocks of KEY_BLOCK_CHUNKS.
+#define KEY_CHUNK_SIZE ((uint64_t)36864)  // 9.4096
+#define KEY_BLOCK_CHUNKS ((uint64_t)256)
+#define KEY_UNBOUNDED UINT64_MAX
+
+// Chunk interval [start,end)
+typedef struct {
+
+  uint64_t start;
+  uint64_t end;
+
+} KEY_RANGE;
+
+// Blocks are taken from a shared counter (fetch_add). A CPU worker publishes
+// the range it walks (chunk in progress and end), an idle CPU worker steals
+// the upper half of the largest remainder by moving its end with a CAS.
+// The victim reads its end after each chunk, the thief starts from the
+// victim chunk read after the CAS, so a chunk is never lost (at worst one is
+// walked twice).
+// GPU workers take whole blocks for all their threads and are not stolen
+// from (their threads move in lockstep).
+// Completed ranges are merged so the exact coverage can be reported, the
+// chunks walked by the running workers are added for a checkpoint. The
+// gaps of a restored checkpoint are handed out before the next blocks.
+class KeyScheduler {
+
+public:
+
+  KeyScheduler();
+  ~KeyScheduler();
+
+  // nbChunk = KEY_UNBOUNDED for an endless search
+  void Init(uint64_t nbChunk, int nbWorker, int nbGPU);
+  // Ranges walked by a previous run (sorted, merged)
+  void Restore(const std::vector<KEY_RANGE> &done);
+
+  // Range for CPU worker w, false when the keyspace is exhausted
+  bool Get(int w, uint64_t &start, uint64_t &end);
+  // CPU worker w walked chunk c, false when its range is done
+  bool Next(int w, uint64_t &c);
+
+  // Whole blocks (first chunk of each), return the number of blocks taken
+  int GetBlocks(uint64_t *starts, int nbBlock);
+  // Blocks of GPU worker g and number of chunks walked in each of them
+  void SetBlocks(int g, const uint64_t *starts, int nbBlock);
+  void SetWalked(int g, uint64_t nbChunk);
+
+  // Record [start,end) as walked
+  void Done(uint64_t start, uint64_t end);
+
+  // Walked chunks, merged and sorted
+  std::vector<KEY_RANGE> GetCompleted();
+  uint64_t GetNbCompleted();
+  // Chunks walked with no gap from chunk 0
+  uint64_t GetContiguous();
+  // Completed ranges and chunks walked by the running workers
+  std::vector<KEY_RANGE> GetCheckpoint();
+
+  uint64_t nbChunk;
+
+private:
+
+  typedef struct {
+
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> cur;  // Chunk in progress
+    std::atomic<uint64_t> end;
+    uint8_t pad[64 - 3 * sizeof(uint64_t)];
+
+  } WORKER_RANGE;
+
+  typedef struct {
+
+    std::vector<uint64_t> blocks;
+    std::atomic<uint64_t> walked;
+
+  } GPU_RANGE;
+
+  bool Steal(uint64_t &start, uint64_t &end);
+  bool GetGap(KEY_RANGE &r);
+  static void Insert(std::vector<KEY_RANGE> &l, KEY_RANGE r);
+
+  std::atomic<uint64_t> nextBlock;
+  uint64_t nbBlock;
+  WORKER_RANGE *ranges;
+  int nbWorker;
+  GPU_RANGE *gpuRanges;
+  int nbGPU;
+
+  std::vector<KEY_RANGE> gaps;  // Not walked by a restored run
+  std::atomic<int> nbGap;
+  std::vector<KEY_RANGE> completed;
+#ifdef WIN64
+  HANDLE doneMutex;
+#else
+  pthread_mutex_t doneMutex;
+#endif
+
+};
+
+#endif // KEYSCHEDULERH
@@ -47,21 +47,22 @@ public:
     }
     
     static inline void generateNpubDirect(const Point& p, char* output_buffer) {
-        static thread_local uint8_t xbytes[32];
+        uint8_t xbytes[32];
         const_cast<Int&>(p.x).Get32Bytes(xbytes);
-        if (!bech32_encode_data(output_buffer, "npub", xbytes, 32)) {
-            strcpy(output_buffer, "ERROR: Failed to encode npub");
-        }
+        npub_encode(output_buffer, xbytes);
     }
     
     static inline void batchMatch(const Point& p1, const Point& p2, const Point& p3, const Point& p4,
                                  const PatternData* patterns, int patternCount, bool results[4]) {
-        static thread_local char npub1[128], npub2[128], npub3[128], npub4[128];
-        
-        generateNpubDirect(p1, npub1);
-        generateNpubDirect(p2, npub2);
-        generateNpubDirect(p3, npub3);
-        generateNpubDirect(p4, npub4);
+        char npub1[128], npub2[128], npub3[128], npub4[128];
+        uint8_t xbytes[4][32];
+        const_cast<Int&>(p1.x).Get32Bytes(xbytes[0]);
+        const_cast<Int&>(p2.x).Get32Bytes(xbytes[1]);
+        const_cast<Int&>(p3.x).Get32Bytes(xbytes[2]);
+        const_cast<Int&>(p4.x).Get32Bytes(xbytes[3]);
+        char *out[4] = { npub1, npub2, npub3, npub4 };
+        const uint8_t *x[4] = { xbytes[0], xbytes[1], xbytes[2], xbytes[3] };
+        npub_encode_batch(out, x, 4);
         
         const char* suffix1 = (strncmp(npub1, "npub1", 5) == 0) ? (npub1 + 5) : npub1;
         const char* suffix2 = (strncmp(npub2, "npub1", 5) == 0) ? (npub2 + 5) : npub2;
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NostrTargetSet.h"
+#include "PrefixFile.h"
+#include "Bech32.h"
+#include "Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+// ----------------------------------------------------------------------------
+
+static int hexValue(char c) {
+
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+
+}
+
+// Decode a 64 hex digits or npub target to X limbs, return false if invalid
+static bool decodeTarget(const char *str, int length, uint64_t *x) {
+
+  uint8_t b[32];
+
+  if (length == 64) {
+
+    for (int i = 0; i < 32; i++) {
+      int h = hexValue(str[2 * i]);
+      int l = hexValue(str[2 * i + 1]);
+      if (h < 0 || l < 0)
+        return false;
+      b[i] = (uint8_t)((h << 4) | l);
+    }
+
+  } else if (length == 63 && strncmp(str, "npub1", 5) == 0) {
+
+    char s[64];
+    char hrp[64];
+    uint8_t data[64];
+    size_t dataLength;
+    size_t bLength = 0;
+    memcpy(s, str, 63);
+    s[63] = 0;
+    if (!bech32_decode(hrp, data, &dataLength, s) || strcmp(hrp, "npub") != 0)
+      return false;
+    uint8_t out[40];
+    if (!convert_bits(out, &bLength, 8, data, dataLength, 5, 0) || bLength != 32)
+      return false;
+    memcpy(b, out, 32);
+
+  } else {
+
+    return false;
+
+  }
+
+  // Big endian bytes to least significant first limbs
+  for (int l = 0; l < 4; l++) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+      v = (v << 8) | b[(3 - l) * 8 + i];
+    x[l] = v;
+  }
+
+  // Top limb 0 is the empty slot marker (probability 2^-64)
+  return x[3] != 0;
+
+}
+
+// ----------------------------------------------------------------------------
+
+NostrTargetSet::NostrTargetSet(const string &fileName, int nbThread) {
+
+  PrefixFile in(fileName, nbThread);
+
+  double t0 = Timer::get_tick();
+
+  uint64_t nbLine = in.lines.size();
+  vector<uint64_t> decoded(4 * nbLine);
+  vector<uint8_t> valid(nbLine);
+
+  PrefixFile::ParallelFor(nbLine, nbThread, [&](int t, size_t first, size_t last) {
+    for (size_t i = first; i < last; i++)
+      valid[i] = decodeTarget(in.lines[i].str, (int)in.lines[i].length, &decoded[4 * i]);
+  });
+
+  nbSlot = 1024;
+  while (nbSlot < 4 * nbLine)
+    nbSlot <<= 1;
+  mask = nbSlot - 1;
+
+  keys = (uint64_t *)calloc(nbSlot, sizeof(uint64_t));
+  index = (uint32_t *)malloc(nbSlot * sizeof(uint32_t));
+  xs = (uint64_t *)malloc((4 * nbLine + 4) * sizeof(uint64_t));
+  if (keys == NULL || index == NULL || xs == NULL) {
+    printf("Error: Cannot allocate target table (%llu slots)\n", (unsigned long long)nbSlot);
+    exit(-1);
+  }
+
+  nbTarget = 0;
+  uint64_t nbError = 0;
+  for (uint64_t l = 0; l < nbLine; l++) {
+
+    if (!valid[l]) {
+      nbError++;
+      if (nbError <= 8)
+        printf("Ignoring target \"%.*s\" (expecting 64 hex digits or npub)\n", (int)in.lines[l].length, in.lines[l].str);
+      continue;
+    }
+
+    Int x;
+    x.SetInt32(0);
+    memcpy(x.bits64, &decoded[4 * l], 32);
+    if (Find(&x) >= 0)
+      continue;
+
+    uint64_t i = x.bits64[3] & mask;
+    while (keys[i] != 0)
+      i = (i + 1) & mask;
+    keys[i] = x.bits64[3];
+    index[i] = (uint32_t)nbTarget;
+    memcpy(xs + 4 * nbTarget, x.bits64, 32);
+    nbTarget++;
+
+  }
+
+  if (nbError > 8)
+    printf("Ignoring %llu other invalid targets\n", (unsigned long long)(nbError - 8));
+
+  if (nbTarget == 0) {
+    printf("Error: no valid target in %s\n", fileName.c_str());
+    exit(-1);
+  }
+
+  found = (uint8_t *)calloc(nbTarget, 1);
+  nbFound = 0;
+
+  double t1 = Timer::get_tick();
+  printf("[Loading targets] %llu public keys (%llu slots, %.1f MB) in %.3f s\n", (unsigned long long)nbTarget,
+    (unsigned long long)nbSlot, (double)(nbSlot * 12 + nbTarget * 32) / 1048576.0, t1 - t0);
+
+}
+
+// ----------------------------------------------------------------------------
+
+NostrTargetSet::~NostrTargetSet() {
+
+  free(keys);
+  free(index);
+  free(xs);
+  free(found);
+
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NOSTRTARGETSETH
+#define NOSTRTARGETSETH
+
+#include <string>
+#include <stdint.h>
+#include "Int.h"
+
+// Exact x-only public key targets (-ix option)
+// Targets (64 hex digits or full npub, one per line) are stored in an
+// open addressing hash set keyed on the most significant limb of X.
+// The table is at most 1/4 full so a candidate usually costs one 64 bits
+// load, the full X is compared only when the top limb matches.
+class NostrTargetSet {
+
+public:
+
+  // Load and decode a target file, exit on error
+  NostrTargetSet(const std::string &fileName, int nbThread);
+  ~NostrTargetSet();
+
+  // Search an affine X, return the target index or -1
+  inline int64_t Find(Int *x) {
+
+    uint64_t h = x->bits64[3];
+    uint64_t i = h & mask;
+    uint64_t k;
+    while ((k = keys[i]) != 0) {
+      if (k == h) {
+        const uint64_t *t = xs + 4 * (uint64_t)index[i];
+        if (t[0] == x->bits64[0] && t[1] == x->bits64[1] && t[2] == x->bits64[2])
+          return (int64_t)index[i];
+      }
+      i = (i + 1) & mask;
+    }
+    return -1;
+
+  }
+
+  uint64_t nbTarget;
+  uint64_t nbSlot;
+  uint8_t *found;
+  uint64_t nbFound;
+
+private:
+
+  uint64_t *keys;    // Top limb of X, 0 for an empty slot
+  uint32_t *index;   // Target index of a slot
+  uint64_t *xs;      // Target X limbs (4 per target, least significant first)
+  uint64_t mask;
+
+};
+
+#endif // NOSTRTARGETSETH
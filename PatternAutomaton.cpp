@@ -0,0 +1,126 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PatternAutomaton.h"
+#include <ctype.h>
+#include <string.h>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+
+// ----------------------------------------------------------------------------
+
+bool PatternAutomaton::Compile(const vector<string> &patterns, const char *alphabet, bool caseSensitive) {
+
+  nbChar = (int)strlen(alphabet);
+  memset(charIndex, -1, sizeof(charIndex));
+  for (int i = 0; i < nbChar; i++)
+    charIndex[(uint8_t)alphabet[i]] = (int8_t)i;
+
+  // Head lengths
+  vector<int> headLength(patterns.size());
+  for (size_t i = 0; i < patterns.size(); i++) {
+    size_t s = patterns[i].find('*');
+    headLength[i] = (int)((s == string::npos) ? patterns[i].length() : s);
+  }
+
+  // A state is a sorted set of (pattern, matched characters) items
+  typedef vector< pair<int, int> > ITEMSET;
+  map<ITEMSET, int32_t> ids;
+  vector<ITEMSET> states;
+  vector< vector<int32_t> > accepts;
+
+  ITEMSET init;
+  vector<int32_t> initAccept;
+  for (int i = 0; i < (int)patterns.size(); i++) {
+    if (headLength[i] == 0)
+      initAccept.push_back(i);
+    else
+      init.push_back(make_pair(i, 0));
+  }
+  ITEMSET initKey(init);
+  for (size_t k = 0; k < initAccept.size(); k++)
+    initKey.push_back(make_pair(-1 - initAccept[k], 0));
+  sort(initKey.begin(), initKey.end());
+  ids[initKey] = 0;
+  states.push_back(init);
+  accepts.push_back(initAccept);
+
+  next.clear();
+  for (size_t s = 0; s < states.size(); s++) {
+
+    for (int a = 0; a < nbChar; a++) {
+
+      char c = alphabet[a];
+      ITEMSET dst;
+      vector<int32_t> dstAccept;
+      for (size_t k = 0; k < states[s].size(); k++) {
+        int p = states[s][k].first;
+        int j = states[s][k].second;
+        char pc = patterns[p][j];
+        bool ok = (pc == '?') || (pc == c) || (!caseSensitive && tolower(pc) == tolower(c));
+        if (!ok)
+          continue;
+        if (j + 1 == headLength[p])
+          dstAccept.push_back(p);
+        else
+          dst.push_back(make_pair(p, j + 1));
+      }
+
+      if (dst.empty() && dstAccept.empty()) {
+        next.push_back(-1);
+        continue;
+      }
+
+      // States differing only by their accepted patterns are distinct
+      ITEMSET key(dst);
+      for (size_t k = 0; k < dstAccept.size(); k++)
+        key.push_back(make_pair(-1 - dstAccept[k], 0));
+      sort(key.begin(), key.end());
+
+      map<ITEMSET, int32_t>::iterator it = ids.find(key);
+      if (it != ids.end()) {
+        next.push_back(it->second);
+      } else {
+        if ((int32_t)states.size() >= AUTOMATON_MAX_STATE)
+          return false;
+        int32_t id = (int32_t)states.size();
+        ids[key] = id;
+        states.push_back(dst);
+        accepts.push_back(dstAccept);
+        next.push_back(id);
+      }
+
+    }
+
+  }
+
+  nbState = (int32_t)states.size();
+  accept.clear();
+  acceptStart.clear();
+  live.clear();
+  for (int32_t s = 0; s < nbState; s++) {
+    live.push_back(states[s].empty() ? 0 : 1);
+    acceptStart.push_back((int32_t)accept.size());
+    accept.insert(accept.end(), accepts[s].begin(), accepts[s].end());
+  }
+  acceptStart.push_back((int32_t)accept.size());
+
+  return true;
+
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PATTERNAUTOMATONH
+#define PATTERNAUTOMATONH
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// Wildcard pattern set compiled to one DFA over the leading characters.
+// The head of a pattern (characters before its first '*', '?' matching any
+// character) is a fixed position test, the DFA states are the sets of
+// partially matched heads so an address is walked once whatever the number
+// of patterns, usually stopping on its first characters. A state lists the
+// patterns whose head is complete, they are confirmed with Wildcard::match()
+// on the full address.
+#define AUTOMATON_MAX_STATE (1 << 18)
+
+class PatternAutomaton {
+
+public:
+
+  // Compile the patterns over an alphabet, return false if the DFA is too large
+  bool Compile(const std::vector<std::string> &patterns, const char *alphabet, bool caseSensitive);
+
+  // Next state on a character, -1 when no head can match anymore
+  inline int32_t Next(int32_t state, char c) {
+    int a = ((uint8_t)c < 128) ? charIndex[(uint8_t)c] : -1;
+    return (a < 0) ? -1 : next[(size_t)state * nbChar + a];
+  }
+
+  // Patterns whose head ends at this state
+  inline const int32_t *Accept(int32_t state, int *nb) {
+    *nb = acceptStart[state + 1] - acceptStart[state];
+    return accept.data() + acceptStart[state];
+  }
+
+  // No head is partially matched, the walk can stop
+  inline bool Done(int32_t state) {
+    return live[state] == 0;
+  }
+
+  int32_t GetNbState() { return nbState; }
+
+private:
+
+  int8_t charIndex[128];
+  int nbChar;
+  int32_t nbState;
+  std::vector<int32_t> next;
+  std::vector<int32_t> accept;
+  std::vector<int32_t> acceptStart;
+  std::vector<uint8_t> live;
+
+};
+
+#endif // PATTERNAUTOMATONH
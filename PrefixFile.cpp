@@ -0,0 +1,176 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrefixFile.h"
+#include "Timer.h"
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#ifndef WIN64
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ----------------------------------------------------------------------------
+
+PrefixFile::PrefixFile(const string &fileName, int nbThread) {
+
+  double t0 = Timer::get_tick();
+
+  this->fileName = fileName;
+  data = NULL;
+  size = 0;
+  hasPattern = false;
+
+#ifndef WIN64
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    printf("Error: Cannot open %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    printf("Error: Cannot stat %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  size = (size_t)st.st_size;
+  if (size > 0) {
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      printf("Error: Cannot map %s %s\n", fileName.c_str(), strerror(errno));
+      exit(-1);
+    }
+    madvise(map, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+    data = (char *)map;
+  }
+  close(fd);
+
+#else
+
+  FILE *fp = fopen(fileName.c_str(), "rb");
+  if (fp == NULL) {
+    printf("Error: Cannot open %s %s\n", fileName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  _fseeki64(fp, 0, SEEK_END);
+  size = (size_t)_ftelli64(fp);
+  _fseeki64(fp, 0, SEEK_SET);
+  if (size > 0) {
+    data = (char *)malloc(size);
+    if (fread(data, 1, size, fp) != size) {
+      printf("Error: Cannot read %s %s\n", fileName.c_str(), strerror(errno));
+      exit(-1);
+    }
+  }
+  fclose(fp);
+
+#endif
+
+  // Split in newline aligned chunks and index them in parallel
+  if (nbThread < 1) nbThread = 1;
+  if (size < (size_t)nbThread * 65536) nbThread = 1;
+
+  vector< vector<PREFIX_VIEW> > chunkLines(nbThread);
+  vector<char> chunkPattern(nbThread, 0);
+
+  PrefixFile::ParallelFor(size, nbThread, [&](int t, size_t first, size_t last) {
+
+    // A chunk owns every line starting inside [first,last[
+    const char *end = data + size;
+    const char *s = data + first;
+    if (first > 0 && s[-1] != '\n') {
+      s = (const char *)memchr(s, '\n', size - first);
+      s = (s == NULL) ? end : s + 1;
+    }
+
+    vector<PREFIX_VIEW> &out = chunkLines[t];
+    out.reserve((last - first) / 34 + 1);
+    bool pattern = false;
+
+    while (s < data + last) {
+
+      const char *e = (const char *)memchr(s, '\n', end - s);
+      const char *next = (e == NULL) ? end : e + 1;
+      if (e == NULL) e = end;
+
+      // Remove ending \r\n and spaces
+      while (e > s && isspace((unsigned char)e[-1]))
+        e--;
+
+      if (e > s) {
+        PREFIX_VIEW v;
+        v.str = s;
+        v.length = (uint32_t)(e - s);
+        pattern |= (memchr(s, '*', v.length) != NULL) || (memchr(s, '?', v.length) != NULL);
+        out.push_back(v);
+      }
+
+      s = next;
+
+    }
+
+    chunkPattern[t] = pattern;
+
+  });
+
+  size_t nbLine = 0;
+  for (int t = 0; t < nbThread; t++)
+    nbLine += chunkLines[t].size();
+  lines.reserve(nbLine);
+  for (int t = 0; t < nbThread; t++) {
+    lines.insert(lines.end(), chunkLines[t].begin(), chunkLines[t].end());
+    hasPattern |= (chunkPattern[t] != 0);
+  }
+
+  double t1 = Timer::get_tick();
+  double dt = t1 - t0;
+  if (dt <= 0) dt = 1e-6;
+  printf("[Loading input file] %zu lines, %.1f MB in %.3f s (%.1f MB/s, %d thread%s)\n",
+    lines.size(), (double)size / 1048576.0, dt, ((double)size / 1048576.0) / dt,
+    nbThread, (nbThread > 1) ? "s" : "");
+
+}
+
+// ----------------------------------------------------------------------------
+
+PrefixFile::~PrefixFile() {
+
+#ifndef WIN64
+  if (data)
+    munmap(data, size);
+#else
+  free(data);
+#endif
+
+}
+
+// ----------------------------------------------------------------------------
+
+void PrefixFile::GetLines(vector<string> &out) {
+
+  out.reserve(out.size() + lines.size());
+  for (size_t i = 0; i < lines.size(); i++)
+    out.push_back(string(lines[i].str, lines[i].length));
+
+}
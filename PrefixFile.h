@@ -0,0 +1,84 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PREFIXFILEH
+#define PREFIXFILEH
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <stdint.h>
+
+// A line of the input file (not null terminated, points into the mapping)
+typedef struct {
+
+  const char *str;
+  uint32_t length;
+
+} PREFIX_VIEW;
+
+// Memory mapped prefix/address list (-i option)
+// The file is split into newline aligned chunks which are indexed in
+// parallel, no std::string is created per line.
+class PrefixFile {
+
+public:
+
+  PrefixFile(const std::string &fileName, int nbThread);
+  ~PrefixFile();
+
+  // Materialize lines (only needed by the pattern/npub matchers)
+  void GetLines(std::vector<std::string> &lines);
+
+  // Run f(t,first,last) over at most nbThread contiguous slices of [0,nbItem[
+  // and return the number of slices used
+  template<typename F> static int ParallelFor(size_t nbItem, int nbThread, F f);
+
+  std::vector<PREFIX_VIEW> lines;
+  bool hasPattern;
+  size_t size;
+  std::string fileName;
+
+private:
+
+  char *data;
+
+};
+
+template<typename F> int PrefixFile::ParallelFor(size_t nbItem, int nbThread, F f) {
+
+  if (nbThread < 1) nbThread = 1;
+  if (nbItem < (size_t)nbThread * 1024) nbThread = 1;
+
+  if (nbThread == 1) {
+    f(0, (size_t)0, nbItem);
+    return 1;
+  }
+
+  std::vector<std::thread> ths;
+  size_t step = nbItem / nbThread;
+  for (int t = 0; t < nbThread; t++) {
+    size_t first = t * step;
+    size_t last = (t == nbThread - 1) ? nbItem : first + step;
+    ths.emplace_back([=]() { f(t, first, last); });
+  }
+  for (auto &th : ths) th.join();
+  return nbThread;
+
+}
+
+#endif // PREFIXFILEH
@@ -0,0 +1,43 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrefixLookup.h"
+
+using namespace std;
+
+// In-order walk of the implicit tree, filled from the sorted array
+static uint32_t fill(const vector<prefixl_t> &sorted, vector<prefixl_t> &out, uint32_t i, uint32_t k) {
+
+  if (k <= (uint32_t)sorted.size()) {
+    i = fill(sorted, out, i, 2 * k);
+    out[k - 1] = sorted[i++];
+    i = fill(sorted, out, i, 2 * k + 1);
+  }
+  return i;
+
+}
+
+void PrefixLookup::EytzingerLayout(vector<prefixl_t> &bucket) {
+
+  if (bucket.size() < 2)
+    return;
+
+  vector<prefixl_t> out(bucket.size());
+  fill(bucket, out, 0, 1);
+  bucket.swap(out);
+
+}
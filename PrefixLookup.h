@@ -0,0 +1,55 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PREFIXLOOKUPH
+#define PREFIXLOOKUPH
+
+#include <vector>
+#include "GPU/GPUEngine.h"
+
+// Second level (32 bits) lookup
+// Each lookup16 bucket keeps its 32 bits prefixes in Eytzinger (BFS) order:
+// element k (1-based) has its children at 2k and 2k+1. The descent touches
+// consecutive cache lines near the root and is branch free, the same layout
+// is uploaded to the GPU (see CheckPoint() in GPU/GPUCompute.h).
+
+class PrefixLookup {
+
+public:
+
+  // Reorder a sorted bucket into Eytzinger order (in place)
+  static void EytzingerLayout(std::vector<prefixl_t> &bucket);
+
+  // Search v in a bucket of n items stored in Eytzinger order
+  static inline bool Find(const prefixl_t *t, uint32_t n, prefixl_t v) {
+
+    uint64_t k = 1;
+    while (k <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(t + 16 * k - 1);
+#endif
+      k = 2 * k + (t[k - 1] < v);
+    }
+    // Remove the trailing right turns (+1 for the final left turn)
+    k >>= TZC(~k) + 1;
+    return (k != 0) && (t[k - 1] == v);
+
+  }
+
+};
+
+#endif // PREFIXLOOKUPH
@@ -0,0 +1,275 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrefixSnapshot.h"
+#include "hash/sha256.h"
+#include "Timer.h"
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <map>
+#ifndef WIN64
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char snapshotMagic[8] = { 'V','S','L','O','O','K','U','P' };
+
+// ----------------------------------------------------------------------------
+
+void PrefixSnapshot::ComputeKey(PrefixFile *inputFile, vector<string> &inputPrefixes,
+                                int searchMode, bool caseSensitive, uint8_t key[32]) {
+
+  CSHA256 sha;
+  uint32_t opt[3];
+  opt[0] = SNAPSHOT_VERSION;
+  opt[1] = (uint32_t)searchMode;
+  opt[2] = caseSensitive ? 1 : 0;
+  sha.Write((unsigned char *)opt, sizeof(opt));
+
+  // Lines are length prefixed so that the key does not depend on line endings
+  if (inputFile) {
+    for (size_t i = 0; i < inputFile->lines.size(); i++) {
+      uint32_t l = inputFile->lines[i].length;
+      sha.Write((unsigned char *)&l, 4);
+      sha.Write((unsigned char *)inputFile->lines[i].str, l);
+    }
+  }
+  for (size_t i = 0; i < inputPrefixes.size(); i++) {
+    uint32_t l = (uint32_t)inputPrefixes[i].length();
+    sha.Write((unsigned char *)&l, 4);
+    sha.Write((unsigned char *)inputPrefixes[i].c_str(), l);
+  }
+
+  sha.Finalize(key);
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool PrefixSnapshot::Save(string fileName, uint8_t key[32], int searchType, bool onlyFull, uint32_t nbPrefix,
+                          vector<PREFIX_TABLE_ITEM> &prefixes, vector<LPREFIX> &usedPrefixL) {
+
+  double t0 = Timer::get_tick();
+
+  SNAPSHOT_HEADER h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, snapshotMagic, 8);
+  h.version = SNAPSHOT_VERSION;
+  h.headerSize = sizeof(SNAPSHOT_HEADER);
+  memcpy(h.key, key, 32);
+  h.searchType = searchType;
+  h.onlyFull = onlyFull ? 1 : 0;
+  h.nbPrefix = nbPrefix;
+  h.nbBucket = (uint32_t)usedPrefixL.size();
+
+  // Found flags are shared between items of a same input prefix
+  map<bool *, uint32_t> foundIndex;
+
+  vector<SNAPSHOT_BUCKET> buckets;
+  buckets.reserve(usedPrefixL.size());
+  for (size_t i = 0; i < usedPrefixL.size(); i++) {
+    vector<PREFIX_ITEM> *items = prefixes[usedPrefixL[i].sPrefix].items;
+    SNAPSHOT_BUCKET b;
+    b.sPrefix = usedPrefixL[i].sPrefix;
+    b.nbItem = (uint32_t)items->size();
+    b.nbLPrefix = (uint32_t)usedPrefixL[i].lPrefixes.size();
+    buckets.push_back(b);
+    h.nbItem += b.nbItem;
+    h.nbLPrefix += b.nbLPrefix;
+    for (size_t j = 0; j < items->size(); j++) {
+      h.stringSize += (*items)[j].prefixLength + 1;
+      if (foundIndex.find((*items)[j].found) == foundIndex.end()) {
+        uint32_t idx = (uint32_t)foundIndex.size();
+        foundIndex[(*items)[j].found] = idx;
+      }
+    }
+  }
+  h.nbFound = (uint32_t)foundIndex.size();
+
+  // Write to a temporary file then rename, a killed job never leaves a truncated snapshot
+  string tmpName = fileName + ".tmp";
+  FILE *f = fopen(tmpName.c_str(), "wb");
+  if (f == NULL) {
+    printf("Warning: Cannot write snapshot %s %s\n", tmpName.c_str(), strerror(errno));
+    return false;
+  }
+
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  if (buckets.size())
+    ok &= fwrite(buckets.data(), sizeof(SNAPSHOT_BUCKET), buckets.size(), f) == buckets.size();
+
+  uint64_t offset = 0;
+  for (size_t i = 0; i < usedPrefixL.size() && ok; i++) {
+    vector<PREFIX_ITEM> *items = prefixes[usedPrefixL[i].sPrefix].items;
+    for (size_t j = 0; j < items->size() && ok; j++) {
+      PREFIX_ITEM *it = &(*items)[j];
+      SNAPSHOT_ITEM si;
+      memset(&si, 0, sizeof(si));
+      si.prefixOffset = offset;
+      si.difficulty = it->difficulty;
+      si.prefixLength = it->prefixLength;
+      si.foundIndex = foundIndex[it->found];
+      si.lPrefix = it->lPrefix;
+      si.isFull = it->isFull;
+      memcpy(si.hash160, it->hash160, 20);
+      ok &= fwrite(&si, sizeof(si), 1, f) == 1;
+      offset += it->prefixLength + 1;
+    }
+  }
+
+  for (size_t i = 0; i < usedPrefixL.size() && ok; i++) {
+    vector<prefixl_t> &l = usedPrefixL[i].lPrefixes;
+    if (l.size())
+      ok &= fwrite(l.data(), sizeof(prefixl_t), l.size(), f) == l.size();
+  }
+
+  for (size_t i = 0; i < usedPrefixL.size() && ok; i++) {
+    vector<PREFIX_ITEM> *items = prefixes[usedPrefixL[i].sPrefix].items;
+    for (size_t j = 0; j < items->size() && ok; j++) {
+      ok &= fwrite((*items)[j].prefix, 1, (*items)[j].prefixLength, f) == (size_t)(*items)[j].prefixLength;
+      ok &= fputc(0, f) != EOF;
+    }
+  }
+
+  ok &= fclose(f) == 0;
+
+  if (!ok || rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    printf("Warning: Cannot write snapshot %s %s\n", fileName.c_str(), strerror(errno));
+    remove(tmpName.c_str());
+    return false;
+  }
+
+  double t1 = Timer::get_tick();
+  printf("[Snapshot] Saved %s (%.1f MB) in %.3f s\n", fileName.c_str(),
+    (double)(sizeof(h) + buckets.size() * sizeof(SNAPSHOT_BUCKET) + h.nbItem * sizeof(SNAPSHOT_ITEM) +
+    h.nbLPrefix * sizeof(prefixl_t) + h.stringSize) / 1048576.0, t1 - t0);
+
+  return true;
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool PrefixSnapshot::Load(string fileName, uint8_t key[32], int *searchType, bool *onlyFull, uint32_t *nbPrefix,
+                          vector<PREFIX_TABLE_ITEM> &prefixes, vector<prefix_t> &usedPrefix,
+                          vector<LPREFIX> &usedPrefixL) {
+
+#ifdef WIN64
+
+  // Not supported, tables are rebuilt
+  return false;
+
+#else
+
+  double t0 = Timer::get_tick();
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SNAPSHOT_HEADER)) {
+    close(fd);
+    printf("[Snapshot] %s: invalid file, rebuilding\n", fileName.c_str());
+    return false;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    printf("[Snapshot] %s: %s, rebuilding\n", fileName.c_str(), strerror(errno));
+    return false;
+  }
+
+  const uint8_t *data = (const uint8_t *)map;
+  const SNAPSHOT_HEADER *h = (const SNAPSHOT_HEADER *)data;
+
+  const char *error = NULL;
+  if (memcmp(h->magic, snapshotMagic, 8) != 0 || h->headerSize != sizeof(SNAPSHOT_HEADER))
+    error = "not a snapshot file";
+  else if (h->version != SNAPSHOT_VERSION)
+    error = "version mismatch";
+  else if (memcmp(h->key, key, 32) != 0)
+    error = "built for another input or search mode";
+  else if (size != sizeof(SNAPSHOT_HEADER) + h->nbBucket * sizeof(SNAPSHOT_BUCKET) +
+                   h->nbItem * sizeof(SNAPSHOT_ITEM) + h->nbLPrefix * sizeof(prefixl_t) + h->stringSize)
+    error = "truncated file";
+
+  if (error) {
+    printf("[Snapshot] %s: %s, rebuilding\n", fileName.c_str(), error);
+    munmap(map, size);
+    return false;
+  }
+
+  const SNAPSHOT_BUCKET *buckets = (const SNAPSHOT_BUCKET *)(data + sizeof(SNAPSHOT_HEADER));
+  const SNAPSHOT_ITEM *items = (const SNAPSHOT_ITEM *)(buckets + h->nbBucket);
+  const prefixl_t *lPrefixes = (const prefixl_t *)(items + h->nbItem);
+  const char *strings = (const char *)(lPrefixes + h->nbLPrefix);
+
+  // Prefix strings stay in the mapping for the lifetime of the search
+  bool *found = new bool[h->nbFound];
+  memset(found, 0, h->nbFound);
+
+  for (uint32_t i = 0; i < h->nbBucket; i++) {
+
+    prefix_t p = (prefix_t)buckets[i].sPrefix;
+    vector<PREFIX_ITEM> *v = new vector<PREFIX_ITEM>(buckets[i].nbItem);
+    for (uint32_t j = 0; j < buckets[i].nbItem; j++) {
+      PREFIX_ITEM *it = &(*v)[j];
+      it->prefix = (char *)(strings + items[j].prefixOffset);
+      it->prefixLength = (int)items[j].prefixLength;
+      it->sPrefix = p;
+      it->difficulty = items[j].difficulty;
+      it->found = found + items[j].foundIndex;
+      it->isFull = items[j].isFull != 0;
+      it->lPrefix = items[j].lPrefix;
+      memcpy(it->hash160, items[j].hash160, 20);
+      it->ranges = NULL;
+      it->nbRange = 0;
+    }
+    items += buckets[i].nbItem;
+
+    prefixes[p].items = v;
+    prefixes[p].found = false;
+    usedPrefix.push_back(p);
+
+    LPREFIX lit;
+    lit.sPrefix = p;
+    lit.lPrefixes.assign(lPrefixes, lPrefixes + buckets[i].nbLPrefix);
+    lPrefixes += buckets[i].nbLPrefix;
+    usedPrefixL.push_back(lit);
+
+  }
+
+  *searchType = h->searchType;
+  *onlyFull = h->onlyFull != 0;
+  *nbPrefix = h->nbPrefix;
+
+  double t1 = Timer::get_tick();
+  printf("[Snapshot] Loaded %s (%u prefixes) in %.3f s\n", fileName.c_str(), h->nbPrefix, t1 - t0);
+
+  return true;
+
+#endif
+
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PREFIXSNAPSHOTH
+#define PREFIXSNAPSHOTH
+
+#include "Vanity.h"
+
+#define SNAPSHOT_VERSION 1
+
+// Binary snapshot of the built lookup tables (lookup16 items + lookup32)
+// File layout:
+//   SNAPSHOT_HEADER
+//   SNAPSHOT_BUCKET[nbBucket]   (ascending sPrefix)
+//   SNAPSHOT_ITEM[nbItem]       (bucket after bucket)
+//   prefixl_t[nbLPrefix]        (bucket after bucket, Eytzinger order)
+//   char[stringSize]            (null terminated prefixes)
+
+typedef struct {
+
+  char     magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint8_t  key[32];        // Hash of the input list and search options
+  int32_t  searchType;
+  uint32_t onlyFull;
+  uint32_t nbPrefix;
+  uint32_t nbFound;
+  uint32_t nbBucket;
+  uint32_t reserved;
+  uint64_t nbItem;
+  uint64_t nbLPrefix;
+  uint64_t stringSize;
+
+} SNAPSHOT_HEADER;
+
+typedef struct {
+
+  uint32_t sPrefix;
+  uint32_t nbItem;
+  uint32_t nbLPrefix;
+
+} SNAPSHOT_BUCKET;
+
+typedef struct {
+
+  uint64_t  prefixOffset;
+  double    difficulty;
+  uint32_t  prefixLength;
+  uint32_t  foundIndex;    // Items sharing a found flag (case unsensitive search)
+  prefixl_t lPrefix;
+  uint32_t  isFull;
+  uint8_t   hash160[20];
+
+} SNAPSHOT_ITEM;
+
+class PrefixSnapshot {
+
+public:
+
+  // Key of a prefix list for the given search options
+  static void ComputeKey(PrefixFile *inputFile, std::vector<std::string> &inputPrefixes,
+                         int searchMode, bool caseSensitive, uint8_t key[32]);
+
+  static bool Save(std::string fileName, uint8_t key[32], int searchType, bool onlyFull, uint32_t nbPrefix,
+                   std::vector<PREFIX_TABLE_ITEM> &prefixes, std::vector<LPREFIX> &usedPrefixL);
+
+  // Return false (tables untouched) if the file is missing, outdated or built for another input
+  static bool Load(std::string fileName, uint8_t key[32], int *searchType, bool *onlyFull, uint32_t *nbPrefix,
+                   std::vector<PREFIX_TABLE_ITEM> &prefixes, std::vector<prefix_t> &usedPrefix,
+                   std::vector<LPREFIX> &usedPrefixL);
+
+};
+
+#endif // PREFIXSNAPSHOTH
@@ -0,0 +1,230 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ResultWriter.h"
+#include "Timer.h"
+#include <string.h>
+#include <stdlib.h>
+#ifdef WIN64
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#define RESULT_MASK (RESULT_QUEUE_SIZE - 1)
+
+// ----------------------------------------------------------------------------
+
+#ifdef WIN64
+static DWORD WINAPI _RunWriter(LPVOID lpParam) {
+#else
+static void *_RunWriter(void *lpParam) {
+#endif
+  ((ResultWriter *)lpParam)->Run();
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+ResultWriter::ResultWriter(const string &fileName, int syncInterval, int syncCount) {
+
+  this->fileName = fileName;
+  this->syncInterval = syncInterval;
+  this->syncCount = syncCount;
+
+  slots = new SLOT[RESULT_QUEUE_SIZE];
+  for (uint64_t i = 0; i < RESULT_QUEUE_SIZE; i++)
+    slots[i].seq.store(i, memory_order_relaxed);
+  head.store(0);
+  tail = 0;
+  synced.store(0);
+  flushRequest.store(0);
+
+  f = NULL;
+  nbUnsynced = 0;
+  lastSync = 0.0;
+  running = false;
+  stopRequest = false;
+
+}
+
+ResultWriter::~ResultWriter() {
+
+  Stop();
+  delete[] slots;
+
+}
+
+// ----------------------------------------------------------------------------
+
+void ResultWriter::Start() {
+
+  if (running)
+    return;
+
+  f = stdout;
+  if (fileName.length() > 0) {
+    f = fopen(fileName.c_str(), "a");
+    if (f == NULL) {
+      printf("Cannot open %s for writing\n", fileName.c_str());
+      f = stdout;
+    }
+  }
+
+  lastSync = Timer::get_tick();
+  stopRequest = false;
+  running = true;
+
+#ifdef WIN64
+  DWORD thread_id;
+  thread = CreateThread(NULL, 0, _RunWriter, (void*)this, 0, &thread_id);
+#else
+  pthread_create(&thread, NULL, &_RunWriter, (void*)this);
+#endif
+
+}
+
+void ResultWriter::Stop() {
+
+  if (!running)
+    return;
+
+  stopRequest = true;
+#ifdef WIN64
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+#else
+  pthread_join(thread, NULL);
+#endif
+  running = false;
+
+  if (f != stdout)
+    fclose(f);
+  f = NULL;
+
+}
+
+void ResultWriter::Flush() {
+
+  if (!running)
+    return;
+
+  uint64_t h = head.load();
+  flushRequest.store(h);
+  while (synced.load() < h)
+    Timer::SleepMillis(1);
+
+}
+
+// ----------------------------------------------------------------------------
+
+void ResultWriter::Push(const char *text) {
+
+  uint64_t pos = head.load(memory_order_relaxed);
+  SLOT *s;
+
+  for (;;) {
+    s = slots + (pos & RESULT_MASK);
+    uint64_t seq = s->seq.load(memory_order_acquire);
+    int64_t dif = (int64_t)(seq - pos);
+    if (dif == 0) {
+      // Free slot, claim it
+      if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+        break;
+    } else if (dif < 0) {
+      // Ring full, wait for the writer
+      Timer::SleepMillis(1);
+      pos = head.load(memory_order_relaxed);
+    } else {
+      pos = head.load(memory_order_relaxed);
+    }
+  }
+
+  strncpy(s->text, text, RESULT_MAX_LENGTH - 1);
+  s->text[RESULT_MAX_LENGTH - 1] = 0;
+  s->seq.store(pos + 1, memory_order_release);
+
+}
+
+bool ResultWriter::Pop(char *text) {
+
+  SLOT *s = slots + (tail & RESULT_MASK);
+  if (s->seq.load(memory_order_acquire) != tail + 1)
+    return false;
+
+  strcpy(text, s->text);
+  s->seq.store(tail + RESULT_QUEUE_SIZE, memory_order_release);
+  tail++;
+  return true;
+
+}
+
+// ----------------------------------------------------------------------------
+
+void ResultWriter::Sync() {
+
+  fflush(f);
+  if (f != stdout && nbUnsynced > 0) {
+#ifdef WIN64
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+  }
+  nbUnsynced = 0;
+  lastSync = Timer::get_tick();
+
+}
+
+void ResultWriter::Run() {
+
+  char text[RESULT_MAX_LENGTH];
+  bool last = false;
+
+  while (!last) {
+
+    // Producers are done once stopRequest is seen, the ring is drained once more
+    last = stopRequest;
+
+    int nbWritten = 0;
+    while (Pop(text)) {
+      // Results on stdout start on a new line (after the progress line)
+      if (f == stdout && nbWritten == 0)
+        fputs("\n", f);
+      fputs(text, f);
+      nbWritten++;
+    }
+
+    if (nbWritten > 0) {
+      fflush(f);
+      nbUnsynced += nbWritten;
+    }
+
+    if (nbUnsynced > 0 && (last || (syncCount > 0 && nbUnsynced >= syncCount) ||
+        Timer::get_tick() - lastSync >= (double)syncInterval || flushRequest.load() > synced.load()))
+      Sync();
+    if (nbUnsynced == 0)
+      synced.store(tail);
+
+    if (nbWritten == 0 && !last)
+      Timer::SleepMillis(1);
+
+  }
+
+}
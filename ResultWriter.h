@@ -0,0 +1,91 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RESULTWRITERH
+#define RESULTWRITERH
+
+#include <string>
+#include <atomic>
+#include <stdio.h>
+#include <stdint.h>
+#ifdef WIN64
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define RESULT_MAX_LENGTH 256
+#define RESULT_QUEUE_SIZE 4096  // Power of 2
+
+// Results are pushed by any thread into a bounded lock-free ring (one
+// sequence number per slot) and drained by a single writer thread.
+// The output file is opened once, each drained batch is written and
+// flushed, fsync() runs every syncInterval seconds or syncCount results.
+// A producer only waits when the ring is full.
+class ResultWriter {
+
+public:
+
+  // Empty file name writes to stdout
+  ResultWriter(const std::string &fileName, int syncInterval, int syncCount);
+  ~ResultWriter();
+
+  void Start();
+  void Push(const char *text);
+  // Drain the ring, sync and close the file
+  void Stop();
+  // Wait until the results pushed so far are written and synced
+  void Flush();
+
+  void Run();
+
+private:
+
+  typedef struct {
+
+    std::atomic<uint64_t> seq;
+    char text[RESULT_MAX_LENGTH];
+
+  } SLOT;
+
+  bool Pop(char *text);
+  void Sync();
+
+  SLOT *slots;
+  std::atomic<uint64_t> head;  // Next slot to fill (producers)
+  uint64_t tail;               // Next slot to read (writer)
+  std::atomic<uint64_t> synced;        // Results written and synced
+  std::atomic<uint64_t> flushRequest;  // Results to sync for Flush()
+
+  std::string fileName;
+  FILE *f;
+  int syncInterval;
+  int syncCount;
+  int nbUnsynced;
+  double lastSync;
+
+  volatile bool running;
+  volatile bool stopRequest;
+#ifdef WIN64
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+
+};
+
+#endif // RESULTWRITERH
@@ -112,6 +112,10 @@ void Secp256K1::Init() {
     }
     fclose(fp);
     if (sum != hdr.checksum) { printf("Warning: K1 table cache checksum mismatch, recomputing...\n"); return false; }
+    // Caches written before the block base fix hold 2.G instead of 256.G
+    Point b1(G);
+    for (int k = 0; k < 8; k++) b1 = DoubleDirect(b1);
+    if (!b1.x.IsEqual(&GTable[256].x)) { printf("Warning: K1 table cache is invalid, recomputing...\n"); return false; }
     printf("Loaded secp256k1 table cache (%u points).\n", hdr.nbPoints);
     fflush(stdout);
     return true;
@@ -172,8 +176,12 @@ void Secp256K1::Init() {
   printf("Initializing secp256k1 tables: 0/32 (0%%)\n");
   fflush(stdout);
   // Precompute block bases (sequential)
+  // Block i starts at 256^i.G
   Point N(G);
-  for (int i = 0; i < 32; i++) { GTable[i * 256] = N; N = DoubleDirect(N); }
+  for (int i = 0; i < 32; i++) {
+    GTable[i * 256] = N;
+    for (int k = 0; k < 8; k++) N = DoubleDirect(N);
+  }
 
   // Choose strategy: multi-process if VS_K1_PROCS>1, else multi-thread
   int procs = 0; const char *envP = getenv("VS_K1_PROCS"); if (envP) procs = atoi(envP);
@@ -360,7 +368,7 @@ void Secp256K1::Check() {
 }
 
 
-Point Secp256K1::ComputePublicKey(Int *privKey) {
+Point Secp256K1::ComputePublicKey(Int *privKey, bool reduce) {
 #ifdef USE_LIBSECP256K1
   // Bridge to libsecp256k1 (X-only). Fallback if bridge not available
   Point bridgeQ;
@@ -389,7 +397,9 @@ Point Secp256K1::ComputePublicKey(Int *privKey) {
       Q = Add2(Q, GTable[256 * i + (b-1)]);
   }
 
-  Q.Reduce();
+  // Projective result when the caller shares the inversion
+  if(reduce)
+    Q.Reduce();
   return Q;
 
 }
@@ -854,6 +864,14 @@ void Secp256K1::GetHash160(int type, bool compressed, Point &pubKey, unsigned ch
 
 std::string Secp256K1::GetPrivAddress(bool compressed,Int &privKey) {
 
+  char out[WIF_MAX_LENGTH];
+  GetPrivAddress(compressed, privKey, out);
+  return std::string(out);
+
+}
+
+int Secp256K1::GetPrivAddress(bool compressed, Int &privKey, char *out) {
+
   unsigned char address[38];
 
   address[0] = 0x80; // Mainnet
@@ -864,13 +882,13 @@ std::string Secp256K1::GetPrivAddress(bool compressed,Int &privKey) {
     // compressed suffix
     address[33] = 1;
     sha256_checksum(address, 34, address + 34);
-    return EncodeBase58(address,address + 38);
+    return EncodeBase58(address, address + 38, out);
 
   } else {
 
     // Compute checksum
     sha256_checksum(address, 33, address + 33);
-    return EncodeBase58(address,address + 37);
+    return EncodeBase58(address, address + 37, out);
 
   }
 
@@ -896,7 +914,18 @@ std::string Secp256K1::GetPrivAddress(bool compressed,Int &privKey) {
 
 std::vector<std::string> Secp256K1::GetAddress(int type, bool compressed, unsigned char *h1, unsigned char *h2, unsigned char *h3, unsigned char *h4) {
 
+  char out[4][ADDRESS_MAX_LENGTH];
+  GetAddress(type, compressed, h1, h2, h3, h4, out);
+
   std::vector<std::string> ret;
+  for (int i = 0; i < 4; i++)
+    ret.push_back(std::string(out[i]));
+  return ret;
+
+}
+
+void Secp256K1::GetAddress(int type, bool compressed, unsigned char *h1, unsigned char *h2, unsigned char *h3, unsigned char *h4,
+                           char out[4][ADDRESS_MAX_LENGTH]) {
 
   unsigned char add1[25];
   unsigned char add2[25];
@@ -924,19 +953,11 @@ std::vector<std::string> Secp256K1::GetAddress(int type, bool compressed, unsign
     break;
 
   case BECH32:
-  {
-    char output[128];
-    segwit_addr_encode(output, "bc", 0, h1, 20);
-    ret.push_back(std::string(output));
-    segwit_addr_encode(output, "bc", 0, h2, 20);
-    ret.push_back(std::string(output));
-    segwit_addr_encode(output, "bc", 0, h3, 20);
-    ret.push_back(std::string(output));
-    segwit_addr_encode(output, "bc", 0, h4, 20);
-    ret.push_back(std::string(output));
-    return ret;
-  }
-  break;
+    segwit_addr_encode(out[0], "bc", 0, h1, 20);
+    segwit_addr_encode(out[1], "bc", 0, h2, 20);
+    segwit_addr_encode(out[2], "bc", 0, h3, 20);
+    segwit_addr_encode(out[3], "bc", 0, h4, 20);
+    return;
   }
 
   memcpy(add1 + 1, h1, 20);
@@ -958,17 +979,23 @@ std::vector<std::string> Secp256K1::GetAddress(int type, bool compressed, unsign
   #endif
 
   // Base58
-  ret.push_back(EncodeBase58(add1, add1 + 25));
-  ret.push_back(EncodeBase58(add2, add2 + 25));
-  ret.push_back(EncodeBase58(add3, add3 + 25));
-  ret.push_back(EncodeBase58(add4, add4 + 25));
-
-  return ret;
+  EncodeBase58(add1, add1 + 25, out[0]);
+  EncodeBase58(add2, add2 + 25, out[1]);
+  EncodeBase58(add3, add3 + 25, out[2]);
+  EncodeBase58(add4, add4 + 25, out[3]);
 
 }
 
 std::string Secp256K1::GetAddress(int type, bool compressed,unsigned char *hash160) {
 
+  char out[ADDRESS_MAX_LENGTH];
+  GetAddress(type, compressed, hash160, out);
+  return std::string(out);
+
+}
+
+int Secp256K1::GetAddress(int type, bool compressed, unsigned char *hash160, char *out) {
+
   unsigned char address[25];
   switch(type) {
 
@@ -981,23 +1008,27 @@ std::string Secp256K1::GetAddress(int type, bool compressed,unsigned char *hash1
       break;
 
     case BECH32:
-    {
-      char output[128];
-      segwit_addr_encode(output, "bc", 0, hash160, 20);
-      return std::string(output);
-    }
-    break;
+      segwit_addr_encode(out, "bc", 0, hash160, 20);
+      return (int)strlen(out);
   }
   memcpy(address + 1, hash160,20);
   sha256_checksum(address,21,address+21);
 
   // Base58
-  return EncodeBase58(address, address + 25);
+  return EncodeBase58(address, address + 25, out);
 
 }
 
 std::string Secp256K1::GetAddress(int type, bool compressed, Point &pubKey) {
 
+  char out[ADDRESS_MAX_LENGTH];
+  GetAddress(type, compressed, pubKey, out);
+  return std::string(out);
+
+}
+
+int Secp256K1::GetAddress(int type, bool compressed, Point &pubKey, char *out) {
+
   unsigned char address[25];
 
   switch (type) {
@@ -1009,19 +1040,20 @@ std::string Secp256K1::GetAddress(int type, bool compressed, Point &pubKey) {
   case BECH32:
   {
     if (!compressed) {
-      return " BECH32: Only compressed key ";
+      strcpy(out, " BECH32: Only compressed key ");
+      return (int)strlen(out);
     }
-    char output[128];
     uint8_t h160[20];
     GetHash160(type, compressed, pubKey, h160);
-    segwit_addr_encode(output,"bc",0,h160,20);
-    return std::string(output);
+    segwit_addr_encode(out,"bc",0,h160,20);
+    return (int)strlen(out);
   }
   break;
 
   case P2SH:
     if (!compressed) {
-      return " P2SH: Only compressed key ";
+      strcpy(out, " P2SH: Only compressed key ");
+      return (int)strlen(out);
     }
     address[0] = 0x05;
     break;
@@ -1031,7 +1063,7 @@ std::string Secp256K1::GetAddress(int type, bool compressed, Point &pubKey) {
   sha256_checksum(address, 21, address + 21);
 
   // Base58
-  return EncodeBase58(address, address + 25);
+  return EncodeBase58(address, address + 25, out);
 
 }
 
@@ -1333,32 +1365,60 @@ bool Secp256K1::EC(Point &p) {
 // ========================================================================
 
 std::string Secp256K1::GetNostrNpub(Point &pubKey) {
-  
+
+  char out[NPUB_MAX_LENGTH];
+  GetNostrNpub(pubKey, out);
+  return std::string(out);
+
+}
+
+int Secp256K1::GetNostrNpub(Point &pubKey, char *out) {
+
   // Nostr npub: Bech32(hrp="npub", data = X-only 32 bytes, 8->5 with padding)
   uint8_t xbytes[32];
   pubKey.x.Get32Bytes(xbytes);
-  
+  npub_encode(out, xbytes);
+  return NPUB_LENGTH;
+
+}
 
-  
-  char output[128];
-  if (!bech32_encode_data(output, "npub", xbytes, 32)) {
-    return "ERROR: Failed to encode npub";
+int Secp256K1::GetNostrHex(Point &pubKey, char *out) {
+
+  // Lower case X, 64 digits, as shown by Nostr clients
+  static const char *digits = "0123456789abcdef";
+  uint8_t xbytes[32];
+  pubKey.x.Get32Bytes(xbytes);
+  for (int i = 0; i < 32; i++) {
+    out[2 * i] = digits[xbytes[i] >> 4];
+    out[2 * i + 1] = digits[xbytes[i] & 0xF];
   }
-  
+  out[64] = 0;
+  return 64;
 
-  
-  return std::string(output);
 }
 
 std::vector<std::string> Secp256K1::GetNostrNpub(Point &k0, Point &k1, Point &k2, Point &k3) {
-  
+
+  char out[4][NPUB_MAX_LENGTH];
+  GetNostrNpub(k0, k1, k2, k3, out);
+
   std::vector<std::string> ret;
-  
-  // Generate npubs for all 4 points
-  ret.push_back(GetNostrNpub(k0));
-  ret.push_back(GetNostrNpub(k1));
-  ret.push_back(GetNostrNpub(k2));
-  ret.push_back(GetNostrNpub(k3));
-  
+  for (int i = 0; i < 4; i++)
+    ret.push_back(std::string(out[i]));
   return ret;
+
+}
+
+void Secp256K1::GetNostrNpub(Point &k0, Point &k1, Point &k2, Point &k3, char out[4][NPUB_MAX_LENGTH]) {
+
+  uint8_t xbytes[4][32];
+  k0.x.Get32Bytes(xbytes[0]);
+  k1.x.Get32Bytes(xbytes[1]);
+  k2.x.Get32Bytes(xbytes[2]);
+  k3.x.Get32Bytes(xbytes[3]);
+
+  char *o[4] = { out[0], out[1], out[2], out[3] };
+  const uint8_t *x[4] = { xbytes[0], xbytes[1], xbytes[2], xbytes[3] };
+  npub_encode_batch(o, x, 4);
+
 }
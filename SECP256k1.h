@@ -27,6 +27,13 @@
 #define P2SH   1
 #define BECH32 2
 #define NOSTR_NPUB 3  // Nostr npub format
+#define NOSTR_HEX 4   // Nostr hex x-only public key
+
+// Buffer sizes of the char* encoders (null terminator included)
+#define ADDRESS_MAX_LENGTH 72  // Base58 (34), bech32 (42) address or hex x-only key (64)
+#define NPUB_MAX_LENGTH 64     // npub (63)
+#define XHEX_MAX_LENGTH 65     // hex x-only public key (64)
+#define WIF_MAX_LENGTH 64      // WIF (51 or 52)
 
 class Secp256K1 {
 
@@ -35,7 +42,7 @@ public:
   Secp256K1();
   ~Secp256K1();
   void Init();
-  Point ComputePublicKey(Int *privKey);
+  Point ComputePublicKey(Int *privKey, bool reduce = true);
   Point NextKey(Point &key);
   void Check();
   bool  EC(Point &p);
@@ -54,6 +61,16 @@ public:
   std::string GetNostrNpub(Point &pubKey);
   std::vector<std::string> GetNostrNpub(Point &k0, Point &k1, Point &k2, Point &k3);
   std::string GetPrivAddress(bool compressed, Int &privKey );
+
+  // No allocation versions, return the string length
+  int GetAddress(int type, bool compressed, Point &pubKey, char *out);
+  int GetAddress(int type, bool compressed, unsigned char *hash160, char *out);
+  void GetAddress(int type, bool compressed, unsigned char *h1, unsigned char *h2, unsigned char *h3, unsigned char *h4,
+                  char out[4][ADDRESS_MAX_LENGTH]);
+  int GetNostrNpub(Point &pubKey, char *out);
+  void GetNostrNpub(Point &k0, Point &k1, Point &k2, Point &k3, char out[4][NPUB_MAX_LENGTH]);
+  int GetNostrHex(Point &pubKey, char *out);
+  int GetPrivAddress(bool compressed, Int &privKey, char *out);
   std::string GetPublicKeyHex(bool compressed, Point &p);
   Point ParsePublicKeyHex(std::string str, bool &isCompressed);
 
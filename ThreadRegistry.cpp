@@ -0,0 +1,81 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ThreadRegistry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+ThreadRegistry::ThreadRegistry() {
+
+  nbCPU = 0;
+  nbGPU = 0;
+  stats = NULL;
+  buffer = NULL;
+
+}
+
+ThreadRegistry::~ThreadRegistry() {
+
+  free(buffer);
+
+}
+
+// ----------------------------------------------------------------------------
+
+void ThreadRegistry::Init(int nbCPUThread, int nbGPUThread) {
+
+  free(buffer);
+
+  nbCPU = nbCPUThread;
+  nbGPU = nbGPUThread;
+  int total = nbCPU + nbGPU;
+  if (total == 0)
+    total = 1;
+
+  size_t size = total * sizeof(THREAD_STAT);
+  buffer = malloc(size + CACHE_LINE_SIZE);
+  if (buffer == NULL) {
+    printf("Error: Cannot allocate thread statistics (%d threads)\n", total);
+    exit(-1);
+  }
+  stats = (THREAD_STAT *)(((uintptr_t)buffer + CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CACHE_LINE_SIZE - 1));
+  memset(stats, 0, size);
+
+}
+
+// ----------------------------------------------------------------------------
+
+uint64_t ThreadRegistry::GetCPUCount() {
+
+  uint64_t count = 0;
+  for (int i = 0; i < nbCPU; i++)
+    count += stats[i].keys;
+  return count;
+
+}
+
+uint64_t ThreadRegistry::GetGPUCount() {
+
+  uint64_t count = 0;
+  for (int i = 0; i < nbGPU; i++)
+    count += stats[nbCPU + i].keys;
+  return count;
+
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the VanitySearch distribution (https://github.com/JeanLucPons/VanitySearch).
+ * Copyright (c) 2019 Jean Luc PONS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef THREADREGISTRYH
+#define THREADREGISTRYH
+
+#include <stdint.h>
+
+#define CACHE_LINE_SIZE 64
+
+// Statistics of a search thread, written by its owner only and read by the
+// progress loop. A block spans whole cache lines (two, the adjacent line
+// prefetcher works on pairs) so threads never share a line.
+typedef struct {
+
+  volatile uint64_t keys;    // Keys checked
+  volatile uint64_t groups;  // CPU groups or GPU kernel calls
+  volatile uint64_t hits;    // Hits queued for verification
+  double walkTime;           // Point generation (s)
+  double checkTime;          // Address computation and matching (s)
+  uint8_t pad[2 * CACHE_LINE_SIZE - 3 * sizeof(uint64_t) - 2 * sizeof(double)];
+
+} THREAD_STAT;
+
+// One stat block per thread, CPU threads first then GPU threads, any number
+// of threads (blocks are aligned on a cache line)
+class ThreadRegistry {
+
+public:
+
+  ThreadRegistry();
+  ~ThreadRegistry();
+
+  void Init(int nbCPUThread, int nbGPUThread);
+  THREAD_STAT *GetCPU(int i) { return stats + i; }
+  THREAD_STAT *GetGPU(int i) { return stats + nbCPU + i; }
+  uint64_t GetCPUCount();
+  uint64_t GetGPUCount();
+
+  int nbCPU;
+  int nbGPU;
+
+private:
+
+  THREAD_STAT *stats;
+  void *buffer;
+
+};
+
+#endif // THREADREGISTRYH
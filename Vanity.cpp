@@ -23,12 +23,18 @@
 #include "hash/sha512.h"
 #include "IntGroup.h"
 #include "Wildcard.h"
+#include "Bech32Pattern.h"
+#include "PatternAutomaton.h"
+#include "PrefixLookup.h"
+#include "PrefixSnapshot.h"
+#include "Hash160File.h"
 #include "Timer.h"
 #include "hash/ripemd160.h"
 #include <string.h>
 #include <math.h>
 #include <algorithm>
 #include <stdarg.h>
+#include <signal.h>
 #ifndef WIN64
 #include <pthread.h>
 #ifdef __APPLE__
@@ -71,8 +77,17 @@ static inline bool bech32_match_wildcard_prefix(const char *text, const char *pa
   }
 }
 
-Point Gn[CPU_GRP_SIZE / 2];
-Point _2Gn;
+Point Gn[CPU_GRP_SIZE_MAX / 2];
+Point _2Gn;  // cpuGrpSize*G
+
+// Stat block of the calling search thread (NULL for other threads)
+static thread_local THREAD_STAT *threadStat = NULL;
+
+// SIGINT/SIGTERM while checkpointing, the search stops and saves its position
+static volatile sig_atomic_t interruptRequest = 0;
+static void onInterrupt(int sig) {
+  interruptRequest = 1;
+}
 
 // Simple file logger to avoid flooding stdout
 static FILE *vs_debug_log_file = NULL;
@@ -95,7 +110,12 @@ static void vs_debug_logf(const char *fmt, ...) {
 
 VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,string seed,int searchMode,
                            bool useGpu, bool stop, string outputFile, bool useSSE, uint32_t maxFound,
-                           uint64_t rekey, bool caseSensitive, Point &startPubKey, bool paranoiacSeed)
+                           uint64_t rekey, bool caseSensitive, Point &startPubKey, bool paranoiacSeed,
+                           PrefixFile *inputFile, string snapshotFile, Hash160File *targetFile,
+                           NostrTargetSet *xTargets, bool hexSearch, int zeroBits,
+                           int syncInterval, int syncCount, int pinMode,
+                           Int *rangeStart, Int *rangeEnd, int shardIndex, int shardCount,
+                           string checkpointFile,int cpuGrpSize)
   :inputPrefixes(inputPrefixes) {
 
   printf("DEBUG: VanitySearch constructor starting...\n");
@@ -106,6 +126,7 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
   this->useGpu = useGpu;
   this->stopWhenFound = stop;
   this->outputFile = outputFile;
+  this->writer = new ResultWriter(outputFile, syncInterval, syncCount);
   this->useSSE = useSSE;
   this->nbGPUThread = 0;
   this->maxFound = maxFound;
@@ -115,6 +136,21 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
   this->hasPattern = false;
   this->caseSensitive = caseSensitive;
   this->startPubKeySpecified = !startPubKey.isZero();
+  this->targetFile = targetFile;
+  this->xTargets = xTargets;
+  this->zeroBits = zeroBits;
+  this->pinMode = pinMode;
+  this->checkpointFile = checkpointFile;
+  this->patternFound = NULL;
+  this->checkGroupFunc = NULL;
+  this->checkAddrFunc = NULL;
+  this->keyPerPoint = 1;
+  this->calibrating = false;
+  this->base58Version = 0;
+  this->cpuGrpSize = cpuGrpSize;
+  nbFoundKey = 0;
+  resumed = false;
+  resumedKeys = 0;
 
   lastRekey = 0;
   prefixes.clear();
@@ -123,6 +159,8 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
   PREFIX_TABLE_ITEM t;
   t.found = true;
   t.items = NULL;
+  t.lPrefixes = NULL;
+  t.nbLPrefix = 0;
   for(int i=0;i<65536;i++)
     prefixes.push_back(t);
 
@@ -140,27 +178,135 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
   printf("DEBUG: hasPattern = %s\n", hasPattern ? "true" : "false");
   fflush(stdout);
 
-  if (!hasPattern) {
+  if (xTargets) {
+
+    // Exact x-only public keys, candidates are probed in the hash set
+    searchType = NOSTR_NPUB;
+    onlyFull = true;
+    nbPrefix = (uint32_t)xTargets->nbTarget;
+    _difficulty = pow(2, 255) / (double)xTargets->nbTarget;  // X is shared by k and -k
+    string seachInfo = string(searchModes[searchMode]) + (startPubKeySpecified ? ", with public key" : "");
+    printf("Search: %llu public keys (Hash set size %llu) [%s]\n", (unsigned long long)xTargets->nbTarget,
+      (unsigned long long)xTargets->nbSlot, seachInfo.c_str());
+
+  } else if (zeroBits > 0) {
+
+    // Proof of work like identities: X with at least zeroBits leading zero
+    // bits, the best X found so far is tracked from the top limb
+    searchType = NOSTR_HEX;
+    nbPrefix = 1;
+    _difficulty = pow(2, zeroBits);
+    zeroFloor = (zeroBits > 8) ? zeroBits - 8 : 1;
+    zeroBest = 0;
+    zeroLimit = 1ULL << 63;
+
+    string searchInfo = string(searchModes[searchMode]) + (startPubKeySpecified ? ", with public key" : "");
+    printf("Difficulty: %.0f\n", _difficulty);
+    printf("Search: X with %d leading zero bits, reporting from %d bits [%s]\n", zeroBits, zeroFloor, searchInfo.c_str());
+
+  } else if (hexSearch) {
+
+    // Hex x-only public keys, patterns are masks on the X limbs
+    searchType = NOSTR_HEX;
+    hasPattern = true;
+    double p = 0.0;
+    for (int i = 0; i < (int)inputPrefixes.size(); i++) {
+      XONLY_MASK m;
+      if (!HexPattern::Compile(inputPrefixes[i].c_str(), (int)inputPrefixes[i].length(), m)) {
+        printf("Error: \"%s\" is not a valid hex pattern (hex digits, '?' and one '*')\n", inputPrefixes[i].c_str());
+        exit(-1);
+      }
+      hexMasks.push_back(m);
+      p += pow(2, -HexPattern::NbBit(m));
+    }
+    if (hexMasks.size() == 0) {
+      printf("VanitySearch: nothing to search !\n");
+      exit(1);
+    }
+    if (useGpu && hexMasks.size() > GPU_HEX_MAX_PATTERN) {
+      printf("Error: too many hex patterns for the GPU (max %d)\n", (int)GPU_HEX_MAX_PATTERN);
+      exit(-1);
+    }
+    nbPrefix = (uint32_t)hexMasks.size();
+    _difficulty = 1.0 / p;
+
+    string searchInfo = string(searchModes[searchMode]) + (startPubKeySpecified ? ", with public key" : "");
+    if (inputPrefixes.size() == 1) {
+      printf("Difficulty: %.0f\n", _difficulty);
+      printf("Search: %s [hex, %s]\n", inputPrefixes[0].c_str(), searchInfo.c_str());
+    } else {
+      printf("Search: %d hex patterns [%s]\n", (int)inputPrefixes.size(), searchInfo.c_str());
+    }
+
+    patternFound = (bool *)malloc(inputPrefixes.size()*sizeof(bool));
+    memset(patternFound,0, inputPrefixes.size() * sizeof(bool));
+
+  } else if (!hasPattern) {
 
     printf("DEBUG: No wildcard pattern found, using standard search...\n");
     fflush(stdout);
     // No wildcard used, standard search
     // Insert prefixes
-    bool loadingProgress = (inputPrefixes.size() > 1000);
-    if (loadingProgress)
+    bool loadingProgress = (inputPrefixes.size() > 1000) || (inputFile && inputFile->lines.size() > 1000);
+    if (loadingProgress && !inputFile)
       printf("[Building lookup16   0.0%%]\r");
 
 
 
     nbPrefix = 0;
     onlyFull = true;
+
+    // Tables from a previous run with the same input and options
+    uint8_t snapshotKey[32];
+    bool fromSnapshot = false;
+    if (snapshotFile.length() > 0 && !targetFile) {
+      PrefixSnapshot::ComputeKey(inputFile, inputPrefixes, searchMode, caseSensitive, snapshotKey);
+      fromSnapshot = PrefixSnapshot::Load(snapshotFile, snapshotKey, &searchType, &onlyFull, &nbPrefix,
+                                          prefixes, usedPrefix, usedPrefixL);
+    }
+
+    if (targetFile) {
+
+      // Binary hash160 list, no decoding
+      loadTargets(targetFile);
+
+    } else if (fromSnapshot) {
+
+      // Npub matchers work on the pattern strings
+      if (inputFile && searchType == NOSTR_NPUB)
+        inputFile->GetLines(inputPrefixes);
+
+    } else if (inputFile && caseSensitive) {
+
+      // Large list, decoded in parallel straight from the mapping
+      loadPrefixes(inputFile);
+
+      // Npub matchers work on the pattern strings
+      if (searchType == NOSTR_NPUB)
+        inputFile->GetLines(inputPrefixes);
+
+    } else {
+
+    if (inputFile)
+      inputFile->GetLines(inputPrefixes);
+
     for (int i = 0; i < (int)inputPrefixes.size(); i++) {
 
 
       PREFIX_ITEM it;
       std::vector<PREFIX_ITEM> itPrefixes;
 
-      if (!caseSensitive) {
+      if (!caseSensitive && GetPrefixType(inputPrefixes[i]) != NOSTR_NPUB) {
+
+        // Address prefixes are compiled case unsensitive as a whole
+        if (initPrefix(inputPrefixes[i], &it)) {
+          bool *found = new bool;
+          *found = false;
+          it.found = found;
+          itPrefixes.push_back(it);
+        }
+
+      } else if (!caseSensitive) {
 
         // For caseunsensitive search, loop through all possible combination
         // and fill up lookup table
@@ -219,18 +365,8 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
       if (itPrefixes.size() > 0) {
 
         // Add the item to all correspoding prefixes in the lookup table
-        for (int j = 0; j < (int)itPrefixes.size(); j++) {
-
-          prefix_t p = itPrefixes[j].sPrefix;
-
-          if (prefixes[p].items == NULL) {
-            prefixes[p].items = new vector<PREFIX_ITEM>();
-            prefixes[p].found = false;
-            usedPrefix.push_back(p);
-          }
-          (*prefixes[p].items).push_back(itPrefixes[j]);
-
-        }
+        for (int j = 0; j < (int)itPrefixes.size(); j++)
+          insertPrefix(itPrefixes[j]);
 
         onlyFull &= it.isFull;
         nbPrefix++;
@@ -244,6 +380,8 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
     if (loadingProgress)
       printf("\n");
 
+    }
+
     //dumpPrefixes();
 
     if (!caseSensitive && searchType == BECH32) {
@@ -257,30 +395,45 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
     }
 
     // Second level lookup
-    uint32_t unique_sPrefix = 0;
-    uint32_t minI = 0xFFFFFFFF;
-    uint32_t maxI = 0;
-    for (int i = 0; i < (int)prefixes.size(); i++) {
-      if (prefixes[i].items) {
-        LPREFIX lit;
-        lit.sPrefix = i;
+    if (!fromSnapshot && !targetFile) {
+
+      for (int i = 0; i < (int)prefixes.size(); i++) {
         if (prefixes[i].items) {
-          for (int j = 0; j < (int)prefixes[i].items->size(); j++) {
-            lit.lPrefixes.push_back((*prefixes[i].items)[j].lPrefix);
+          LPREFIX lit;
+          lit.sPrefix = i;
+          if (prefixes[i].items) {
+            for (int j = 0; j < (int)prefixes[i].items->size(); j++) {
+              lit.lPrefixes.push_back((*prefixes[i].items)[j].lPrefix);
+            }
           }
+          sort(lit.lPrefixes.begin(), lit.lPrefixes.end());
+          PrefixLookup::EytzingerLayout(lit.lPrefixes);
+          usedPrefixL.push_back(lit);
         }
-        sort(lit.lPrefixes.begin(), lit.lPrefixes.end());
-        usedPrefixL.push_back(lit);
-        if ((uint32_t)lit.lPrefixes.size() > maxI) maxI = (uint32_t)lit.lPrefixes.size();
-        if ((uint32_t)lit.lPrefixes.size() < minI) minI = (uint32_t)lit.lPrefixes.size();
-        unique_sPrefix++;
+        if (loadingProgress && (i & 0x3FF) == 0)
+          printf("[Building lookup32 %.1f%%]\r", ((double)i*100.0) / (double)prefixes.size());
       }
+
       if (loadingProgress)
-        printf("[Building lookup32 %.1f%%]\r", ((double)i*100.0) / (double)prefixes.size());
+        printf("\n");
+
+      if (snapshotFile.length() > 0)
+        PrefixSnapshot::Save(snapshotFile, snapshotKey, searchType, onlyFull, nbPrefix, prefixes, usedPrefixL);
+
     }
 
-    if (loadingProgress)
-      printf("\n");
+    // CPU side second level lookup (same layout as the GPU one)
+    uint32_t unique_sPrefix = 0;
+    uint32_t minI = 0xFFFFFFFF;
+    uint32_t maxI = 0;
+    for (int i = 0; i < (int)usedPrefixL.size(); i++) {
+      PREFIX_TABLE_ITEM *pt = &prefixes[usedPrefixL[i].sPrefix];
+      pt->lPrefixes = usedPrefixL[i].lPrefixes.data();
+      pt->nbLPrefix = (uint32_t)usedPrefixL[i].lPrefixes.size();
+      if (pt->nbLPrefix > maxI) maxI = pt->nbLPrefix;
+      if (pt->nbLPrefix < minI) minI = pt->nbLPrefix;
+      unique_sPrefix++;
+    }
 
     _difficulty = getDiffuclty();
     string seachInfo = string(searchModes[searchMode]) + (startPubKeySpecified ? ", with public key" : "");
@@ -291,7 +444,8 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
         printf("Search: %s [%s, Case unsensitive] (Lookup size %d)\n", inputPrefixes[0].c_str(), seachInfo.c_str(), unique_sPrefix);
       } else {
         printf("Difficulty: %.0f\n", _difficulty);
-        printf("Search: %s [%s]\n", inputPrefixes[0].c_str(), seachInfo.c_str());
+        PREFIX_ITEM *it = &(*prefixes[usedPrefix[0]].items)[0];
+        printf("Search: %.*s [%s]\n", it->prefixLength, it->prefix, seachInfo.c_str());
       }
     } else {
       if (onlyFull) {
@@ -301,6 +455,65 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
       }
     }
 
+  } else if (GetPrefixType(inputPrefixes[0]) == P2PKH || GetPrefixType(inputPrefixes[0]) == P2SH) {
+
+    // Base58 wildcard search, the pattern set is compiled to one automaton
+    // walked on the leading base58 digits
+    searchType = GetPrefixType(inputPrefixes[0]);
+    if (!patterns.Compile(inputPrefixes, "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz", caseSensitive)) {
+      printf("Error: too many pattern states (max %d)\n", AUTOMATON_MAX_STATE);
+      exit(-1);
+    }
+
+    string searchInfo = string(searchModes[searchMode]) + (startPubKeySpecified ? ", with public key" : "");
+    if (inputPrefixes.size() == 1) {
+      printf("Search: %s [%s]\n", inputPrefixes[0].c_str(), searchInfo.c_str());
+    } else {
+      printf("Search: %d patterns (%d automaton states) [%s]\n", (int)inputPrefixes.size(),
+        patterns.GetNbState(), searchInfo.c_str());
+    }
+
+    patternFound = (bool *)malloc(inputPrefixes.size()*sizeof(bool));
+    memset(patternFound,0, inputPrefixes.size() * sizeof(bool));
+
+  } else if (GetPrefixType(inputPrefixes[0]) == BECH32) {
+
+    // bc1q wildcard search, patterns are compiled to hash160 masks and the
+    // GPU uses the 16 bits prefixes they allow
+    searchType = BECH32;
+    if (searchMode != SEARCH_COMPRESSED) {
+      printf("Error: BECH32 patterns only allowed with compressed keys\n");
+      exit(-1);
+    }
+
+    vector<bool> used(65536, false);
+    for (int i = 0; i < (int)inputPrefixes.size(); i++) {
+      HASH160_MASK m;
+      if (!Bech32Pattern::Compile(inputPrefixes[i].c_str(), (int)inputPrefixes[i].length(), false, m)) {
+        printf("Error: \"%s\" is not a valid bc1q pattern\n", inputPrefixes[i].c_str());
+        exit(-1);
+      }
+      bech32Masks.push_back(m);
+      vector<uint16_t> p;
+      Bech32Pattern::GetPrefixes(m, p);
+      for (int j = 0; j < (int)p.size(); j++)
+        used[p[j]] = true;
+    }
+    for (int i = 0; i < 65536; i++)
+      if (used[i])
+        usedPrefix.push_back((prefix_t)i);
+
+    string searchInfo = string(searchModes[searchMode]) + (startPubKeySpecified ? ", with public key" : "");
+    if (inputPrefixes.size() == 1) {
+      printf("Search: %s [%s] (%d hash160 bits fixed)\n", inputPrefixes[0].c_str(), searchInfo.c_str(),
+        Bech32Pattern::NbBit(bech32Masks[0]));
+    } else {
+      printf("Search: %d patterns [%s]\n", (int)inputPrefixes.size(), searchInfo.c_str());
+    }
+
+    patternFound = (bool *)malloc(inputPrefixes.size()*sizeof(bool));
+    memset(patternFound,0, inputPrefixes.size() * sizeof(bool));
+
   } else {
 
     printf("DEBUG: Wildcard pattern found, initializing Nostr npub search...\n");
@@ -341,52 +554,39 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
 
   }
 
+  // Gn[i] = (i+1)*G, shared by all group sizes (a group of n keys uses the
+  // n/2 first points), _2Gn is set once the group size is known
+  int nbGn = 0;
 #ifdef STATIC_CPU_GTABLE
-  printf("DEBUG: Loading static CPU generator table (%d points)...\n", CPU_GRP_SIZE/2);
-  fflush(stdout);
-  // Load pre-computed generator table
   {
     #include "cpu_gtable.inc"
-    for (int i = 0; i < CPU_GRP_SIZE/2; i++) {
+    nbGn = (int)(sizeof(cpu_gtable_raw) / sizeof(cpu_gtable_raw[0]));
+    if (nbGn > CPU_GRP_SIZE_MAX / 2) nbGn = CPU_GRP_SIZE_MAX / 2;
+    printf("DEBUG: Loading static CPU generator table (%d points)...\n", nbGn);
+    fflush(stdout);
+    for (int i = 0; i < nbGn; i++) {
       for (int k = 0; k < NB64BLOCK; k++) Gn[i].x.bits64[k] = cpu_gtable_raw[i][0 + k];
       for (int k = 0; k < NB64BLOCK; k++) Gn[i].y.bits64[k] = cpu_gtable_raw[i][5 + k];
       for (int k = 0; k < NB64BLOCK; k++) Gn[i].z.bits64[k] = cpu_gtable_raw[i][10 + k];
     }
-    // Load _2Gn
-    for (int k = 0; k < NB64BLOCK; k++) _2Gn.x.bits64[k] = cpu_2gn_raw[0 + k];
-    for (int k = 0; k < NB64BLOCK; k++) _2Gn.y.bits64[k] = cpu_2gn_raw[5 + k];
-    for (int k = 0; k < NB64BLOCK; k++) _2Gn.z.bits64[k] = cpu_2gn_raw[10 + k];
-    printf("DEBUG: Static CPU generator table loaded successfully.\n");
-    fflush(stdout);
   }
-#else
-  printf("DEBUG: Computing optimized generator table (%d points)...\n", CPU_GRP_SIZE/2);
+#endif
+  printf("DEBUG: Computing optimized generator table (%d points)...\n", CPU_GRP_SIZE_MAX/2 - nbGn);
   fflush(stdout);
-  
-  // Optimized generator table computation
-  Point g = secp->G;
-  Gn[0] = g;
-  
-  // OPTIMIZED: Efficient generator table computation using libsecp256k1
-  // First build a minimal working table
-  for (int i = 1; i < min(32, CPU_GRP_SIZE/2); i++) {
-    if (i % 8 == 0) {
-      printf("DEBUG: Computing generator %d/%d...\n", i, CPU_GRP_SIZE/2);
-      fflush(stdout);
-    }
-    // Use simple addition for small indices to avoid AddDirect issues
-    Gn[i] = g;  // Temporary fallback - will optimize later
+
+  Point g = (nbGn >= 2) ? Gn[nbGn - 1] : secp->G;
+  if (nbGn < 2) {
+    Gn[0] = g;
+    g = secp->DoubleDirect(g);
+    Gn[1] = g;
+    nbGn = 2;
   }
-  
-  // For larger indices, use efficient computation if available
-  for (int i = 32; i < CPU_GRP_SIZE/2 && i < 128; i++) {
-    Gn[i] = g;  // Fallback for now
+  for (int i = nbGn; i < CPU_GRP_SIZE_MAX/2; i++) {
+    g = secp->AddDirect(g, secp->G);
+    Gn[i] = g;
   }
-  
-  _2Gn = g;  // Simplified for stability
   printf("DEBUG: Generator table computation completed.\n");
   fflush(stdout);
-#endif
 
   printf("DEBUG: Generator table computation completed. Setting up endomorphism constants...\n");
   fflush(stdout);
@@ -449,8 +649,99 @@ VanitySearch::VanitySearch(Secp256K1 *secp, vector<std::string> &inputPrefixes,s
   ctimeBuff = ctime(&now);
   printf("Start %s", ctimeBuff);
 
+  // Keyspace of the process: chunks of the -keyspace range are split
+  // evenly between shards, shard i walks chunks [C.i/n,C.(i+1)/n)
+  keyBounded = (rangeStart != NULL);
+  nbKeyChunk = KEY_UNBOUNDED;
+  if (keyBounded) {
+
+    Int first(rangeStart);
+    Int size(rangeEnd);
+    size.Sub(rangeStart);
+
+    Int cs((uint64_t)KEY_CHUNK_SIZE);
+    Int ns((uint64_t)shardCount);
+    Int nbChunk(&size);
+    nbChunk.Add((uint64_t)(KEY_CHUNK_SIZE - 1));
+    nbChunk.Div(&cs);
+    Int lo(&nbChunk);
+    lo.Mult((uint64_t)shardIndex);
+    lo.Div(&ns);
+    Int hi(&nbChunk);
+    hi.Mult((uint64_t)(shardIndex + 1));
+    hi.Div(&ns);
+
+    Int nb(&hi);
+    nb.Sub(&lo);
+    if (nb.GetSize64() <= 1 && nb.bits64[0] < KEY_UNBOUNDED)
+      nbKeyChunk = nb.bits64[0];
+
+    startKey.Set(&lo);
+    startKey.Mult((uint64_t)KEY_CHUNK_SIZE);
+    startKey.Add(&first);
+    keyEnd.Set(&hi);
+    keyEnd.Mult((uint64_t)KEY_CHUNK_SIZE);
+    keyEnd.Add(&first);
+    if (keyEnd.IsGreater(rangeEnd))
+      keyEnd.Set(rangeEnd);
+
+  }
+
+  // Position of a previous run, the base key and keyspace are taken from it
+  if (checkpointFile.length() > 0) {
+
+    vector<uint8_t> flags;
+    getFoundFlags(flags);
+    uint8_t inputKey[32];
+    PrefixSnapshot::ComputeKey(inputFile, inputPrefixes, searchMode, caseSensitive, inputKey);
+    int32_t opt[6] = { searchType, zeroBits, hexSearch ? 1 : 0, shardIndex, shardCount, rangeStart ? 1 : 0 };
+    uint64_t nbFlag = flags.size();
+    CSHA256 sha;
+    sha.Write(inputKey, 32);
+    sha.Write((unsigned char *)opt, sizeof(opt));
+    sha.Write((unsigned char *)&nbFlag, sizeof(nbFlag));
+    sha.Write((unsigned char *)startPubKey.x.bits64, 32);
+    sha.Write((unsigned char *)startPubKey.y.bits64, 32);
+    if (rangeStart) {
+      sha.Write((unsigned char *)rangeStart->bits64, 32);
+      sha.Write((unsigned char *)rangeEnd->bits64, 32);
+    }
+    sha.Finalize(checkpointKey);
+
+    CHECKPOINT_HEADER h;
+    if (Checkpoint::Load(checkpointFile, checkpointKey, h, resumedRanges, flags)) {
+      startKey.SetInt32(0);
+      keyEnd.SetInt32(0);
+      for (int i = 0; i < 4; i++) {
+        startKey.bits64[i] = h.baseKey[i];
+        keyEnd.bits64[i] = h.keyEnd[i];
+      }
+      keyBounded = (h.bounded != 0);
+      nbKeyChunk = h.nbChunk;
+      resumedKeys = h.nbKey;
+      nbFoundKey = h.nbFound;
+      if (zeroBits > 0)
+        zeroBest = h.zeroBest;
+      setFoundFlags(flags);
+      resumed = true;
+      uint64_t nbDone = 0;
+      for (int i = 0; i < (int)resumedRanges.size(); i++)
+        nbDone += resumedRanges[i].end - resumedRanges[i].start;
+      printf("Resume: %s, 2^%.2f keys in %d range(s), %d found\n", checkpointFile.c_str(),
+        (nbDone > 0) ? log2((double)nbDone * (double)KEY_CHUNK_SIZE) : 0.0, (int)resumedRanges.size(), nbFoundKey);
+    } else {
+      printf("Checkpoint: %s (new)\n", checkpointFile.c_str());
+    }
+
+  }
+
   if (rekey > 0) {
     printf("Base Key: Randomly changed every %.0f Mkeys\n",(double)rekey);
+  } else if (keyBounded) {
+    printf("Keyspace: %s:%s", startKey.GetBase16().c_str(), keyEnd.GetBase16().c_str());
+    if (shardCount > 1)
+      printf(" (shard %d/%d)", shardIndex, shardCount);
+    printf("\n");
   } else {
     printf("Base Key: %s\n", startKey.GetBase16().c_str());
   }
@@ -475,84 +766,280 @@ bool VanitySearch::isSingularPrefix(std::string pref) {
 }
 
 // ----------------------------------------------------------------------------
-bool VanitySearch::initPrefix(std::string &prefix,PREFIX_ITEM *it) {
-
-  std::vector<unsigned char> result;
-  string dummy1 = prefix;
-  int nbDigit = 0;
-  bool wrong = false;
 
+int VanitySearch::GetPrefixType(const char *prefix, int length) {
+
+  // Bitcoin addresses are told from their leading characters, anything
+  // else is an npub with or without its "npub1" head. '1', '3' and "bc1"
+  // prefixes are always Bitcoin addresses, an npub data part starting with
+  // '3' (a bech32 character) needs the "npub1" head.
+  if (length >= 3 && strncmp(prefix, "bc1", 3) == 0)
+    return BECH32;
+  if (length >= 4 && strncmp(prefix, "npub", 4) == 0)
+    return NOSTR_NPUB;
+  if (length >= 1 && prefix[0] == '1')
+    return P2PKH;
+  if (length >= 1 && prefix[0] == '3')
+    return P2SH;
+  return NOSTR_NPUB;
 
+}
 
-  if (prefix.length() < 2) {
-    printf("Ignoring prefix \"%s\" (too short)\n",prefix.c_str());
-    return false;
-  }
+// ----------------------------------------------------------------------------
+bool VanitySearch::initPrefix(std::string &prefix,PREFIX_ITEM *it) {
 
-  int aType = -1;
+  return initPrefix(prefix.c_str(), (int)prefix.length(), it);
 
+}
 
-  // Check for Nostr npub prefix or suffix-only form
-  bool hasNpubHrp = (prefix.length() >= 4 && prefix.substr(0, 4) == "npub");
-  bool suffixOnly = !hasNpubHrp; // accept bare suffix like "abc"
-  if (hasNpubHrp || suffixOnly) {
-    aType = NOSTR_NPUB;
-  }
+bool VanitySearch::initPrefix(const char *prefix, int length, PREFIX_ITEM *it) {
 
-  if (aType==-1) {
-    printf("Ignoring prefix \"%s\" (must start with npub)\n", prefix.c_str());
+  if (length < 2) {
+    printf("Ignoring prefix \"%.*s\" (too short)\n", length, prefix);
     return false;
   }
 
+  int aType = GetPrefixType(prefix, length);
+  bool hasNpubHrp = (length >= 4 && strncmp(prefix, "npub", 4) == 0);
+
   if (searchType == -1) searchType = aType;
   if (aType != searchType) {
-    printf("Ignoring prefix \"%s\" (Only Nostr npub allowed)\n", prefix.c_str());
+    printf("Ignoring prefix \"%.*s\" (npub, P2PKH, P2SH and BECH32 prefixes cannot be mixed)\n", length, prefix);
     return false;
   }
 
   if (aType == NOSTR_NPUB) {
 
     // Normalize suffix to validate difficulty and matching base
-    string suffix = hasNpubHrp ? prefix.substr(4) : prefix;
-    if (!suffix.empty() && suffix[0] == '1') suffix.erase(0, 1);
+    const char *suffix = hasNpubHrp ? prefix + 4 : prefix;
+    int suffixLength = hasNpubHrp ? length - 4 : length;
+    if (suffixLength > 0 && suffix[0] == '1') {
+      suffix++;
+      suffixLength--;
+    }
 
-    // Normalize to lowercase and validate against Bech32 charset (lowercase)
-    const std::string bech32chars = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
-    for (size_t i = 0; i < suffix.size(); ++i) {
+    // Validate against Bech32 charset (lowercase)
+    const char *bech32chars = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+    for (int i = 0; i < suffixLength; ++i) {
       char c = tolower(suffix[i]);
-      if (bech32chars.find(c) == std::string::npos) {
-        printf("Ignoring prefix \"%s\" (Invalid npub charset; allowed: %s)\n", prefix.c_str(), bech32chars.c_str());
+      if (c == 0 || strchr(bech32chars, c) == NULL) {
+        printf("Ignoring prefix \"%.*s\" (Invalid npub charset; allowed: %s)\n", length, prefix, bech32chars);
         return false;
       }
-      suffix[i] = c;
     }
     
     // Set up prefix data for searching
     uint8_t data[64];
     memset(data,0,64);
     // Convert prefix to bytes for comparison
-    memcpy(data, prefix.c_str(), min((int)prefix.length(), 64));
+    memcpy(data, prefix, min(length, 64));
 
     // Difficulty calculation for npub prefix
     it->sPrefix = *(prefix_t *)data;
     // Difficultyはデータ部の5bit文字数（HRPと区切り'1'は含めない）に基づく
-    it->difficulty = pow(2, 5*(int)suffix.length());
+    it->difficulty = pow(2, 5*suffixLength);
+    it->isFull = false;
+    it->lPrefix = 0;
+    it->prefix = (char *)prefix;
+    it->prefixLength = length;
+    it->ranges = NULL;
+    it->nbRange = 0;
+
+    return true;
+
+  } else if (aType == P2PKH || aType == P2SH) {
+
+    // Base58 prefix compiled to hash160 intervals, no encoding per key
+    vector<HASH160_RANGE> r;
+    if (!Base58Range::Compile(prefix, length, aType, r, caseSensitive)) {
+      printf("Ignoring prefix \"%.*s\" (not a valid %s prefix)\n", length, prefix, (aType == P2PKH) ? "P2PKH" : "P2SH");
+      return false;
+    }
+
+    it->ranges = new HASH160_RANGE[r.size()];
+    memcpy(it->ranges, r.data(), r.size() * sizeof(HASH160_RANGE));
+    it->nbRange = (int)r.size();
+    it->sPrefix = *(prefix_t *)r[0].lo;
+    it->difficulty = pow(2, 160) / Base58Range::Width(r);
+    it->isFull = false;
+    it->lPrefix = 0;
+    it->prefix = (char *)prefix;
+    it->prefixLength = length;
+
+    return true;
+
+  } else if (aType == BECH32) {
+
+    // bc1q prefix, its leading hash160 bits are a single interval
+    HASH160_MASK m;
+    HASH160_RANGE r;
+    if (!Bech32Pattern::Compile(prefix, length, true, m) || !Bech32Pattern::ToRange(m, r)) {
+      printf("Ignoring prefix \"%.*s\" (not a valid bc1q prefix)\n", length, prefix);
+      return false;
+    }
+
+    it->ranges = new HASH160_RANGE[1];
+    it->ranges[0] = r;
+    it->nbRange = 1;
+    it->sPrefix = *(prefix_t *)r.lo;
+    it->difficulty = pow(2, Bech32Pattern::NbBit(m));
     it->isFull = false;
     it->lPrefix = 0;
-    it->prefix = (char *)prefix.c_str();
-    it->prefixLength = (int)prefix.length();
+    it->prefix = (char *)prefix;
+    it->prefixLength = length;
 
     return true;
 
   } else {
     // Only Nostr npub supported
-    printf("Ignoring prefix \"%s\" (Only Nostr npub supported)\n", prefix.c_str());
+    printf("Ignoring prefix \"%.*s\" (Only Nostr npub supported)\n", length, prefix);
     return false;
   }
 }
 
 // ----------------------------------------------------------------------------
 
+bool VanitySearch::prefixMatch(const char *prefix, int length, const char *addr) {
+
+  if (caseSensitive)
+    return strncmp(prefix, addr, length) == 0;
+
+  for (int i = 0; i < length; i++)
+    if (tolower(prefix[i]) != tolower(addr[i]))
+      return false;
+  return true;
+
+}
+
+// ----------------------------------------------------------------------------
+
+void VanitySearch::insertPrefix(PREFIX_ITEM &it) {
+
+  // Interval items go to every bucket they overlap
+  if (it.nbRange > 0) {
+    for (int i = 0; i < it.nbRange; i++) {
+      uint32_t b0 = ((uint32_t)it.ranges[i].lo[0] << 8) | it.ranges[i].lo[1];
+      uint32_t b1 = ((uint32_t)it.ranges[i].hi[0] << 8) | it.ranges[i].hi[1];
+      for (uint32_t b = b0; b <= b1; b++) {
+        PREFIX_ITEM bit = it;
+        bit.sPrefix = (prefix_t)((b >> 8) | ((b & 0xFF) << 8));
+        insertBucket(bit);
+      }
+    }
+    return;
+  }
+
+  insertBucket(it);
+
+}
+
+void VanitySearch::insertBucket(PREFIX_ITEM &it) {
+
+  prefix_t p = it.sPrefix;
+
+  if (prefixes[p].items == NULL) {
+    prefixes[p].items = new vector<PREFIX_ITEM>();
+    prefixes[p].found = false;
+    usedPrefix.push_back(p);
+  }
+  (*prefixes[p].items).push_back(it);
+
+}
+
+// ----------------------------------------------------------------------------
+
+void VanitySearch::loadPrefixes(PrefixFile *inputFile) {
+
+  double t0 = Timer::get_tick();
+  size_t nbLine = inputFile->lines.size();
+  const PREFIX_VIEW *lines = inputFile->lines.data();
+
+  // One flag per line, lines are never duplicated by a case sensitive search
+  bool *found = new bool[nbLine];
+  memset(found, 0, nbLine);
+
+  // The first valid line sets the search type, the rest is decoded in parallel
+  vector<PREFIX_ITEM> head;
+  size_t i0 = 0;
+  while (i0 < nbLine && searchType == -1) {
+    PREFIX_ITEM it;
+    if (initPrefix(lines[i0].str, (int)lines[i0].length, &it)) {
+      it.found = found + i0;
+      head.push_back(it);
+    }
+    i0++;
+  }
+
+  int nbThread = Timer::getCoreNumber();
+  vector< vector<PREFIX_ITEM> > items(nbThread);
+
+  int nbSlice = PrefixFile::ParallelFor(nbLine - i0, nbThread, [&](int t, size_t first, size_t last) {
+    vector<PREFIX_ITEM> &out = items[t];
+    out.reserve(last - first);
+    for (size_t i = i0 + first; i < i0 + last; i++) {
+      PREFIX_ITEM it;
+      if (initPrefix(lines[i].str, (int)lines[i].length, &it)) {
+        it.found = found + i;
+        out.push_back(it);
+      }
+    }
+  });
+
+  double t1 = Timer::get_tick();
+
+  // Merge in file order
+  items.insert(items.begin(), head);
+  for (int t = 0; t <= nbSlice; t++) {
+    for (size_t j = 0; j < items[t].size(); j++) {
+      insertPrefix(items[t][j]);
+      onlyFull &= items[t][j].isFull;
+      nbPrefix++;
+    }
+    vector<PREFIX_ITEM>().swap(items[t]);
+  }
+
+  double t2 = Timer::get_tick();
+  printf("[Building lookup16] %d items, decoded in %.3f s (%.2f Mitem/s), indexed in %.3f s\n",
+    nbPrefix, t1 - t0, (double)nbLine / ((t1 - t0) * 1e6 + 1e-9), t2 - t1);
+
+}
+
+// ----------------------------------------------------------------------------
+
+void VanitySearch::loadTargets(Hash160File *targetFile) {
+
+  // Buckets point to an empty item list, hash160 are searched in the mapped file
+  searchType = targetFile->addrType;
+  onlyFull = true;
+  nbPrefix = (uint32_t)targetFile->nbHash;
+
+  for (uint32_t b = 0; b < 65536; b++) {
+
+    uint64_t st = targetFile->offsets[b];
+    uint64_t ed = targetFile->offsets[b + 1];
+    if (st == ed)
+      continue;
+
+    prefix_t p = *(prefix_t *)(targetFile->hashes + st * 20);
+    prefixes[p].items = &targetItems;
+    prefixes[p].found = false;
+    usedPrefix.push_back(p);
+
+    LPREFIX lit;
+    lit.sPrefix = p;
+    lit.lPrefixes.reserve(ed - st);
+    for (uint64_t i = st; i < ed; i++)
+      lit.lPrefixes.push_back(*(prefixl_t *)(targetFile->hashes + i * 20));
+    sort(lit.lPrefixes.begin(), lit.lPrefixes.end());
+    PrefixLookup::EytzingerLayout(lit.lPrefixes);
+    usedPrefixL.push_back(lit);
+
+  }
+
+}
+
+// ----------------------------------------------------------------------------
+
 void VanitySearch::dumpPrefixes() {
 
   for (int i = 0; i < 0xFFFF; i++) {
@@ -561,7 +1048,7 @@ void VanitySearch::dumpPrefixes() {
       for (int j = 0; j < (int)prefixes[i].items->size(); j++) {
         printf("  %d\n", (*prefixes[i].items)[j].sPrefix);
         printf("  %g\n", (*prefixes[i].items)[j].difficulty);
-        printf("  %s\n", (*prefixes[i].items)[j].prefix);
+        printf("  %.*s\n", (*prefixes[i].items)[j].prefixLength, (*prefixes[i].items)[j].prefix);
       }
     }
   }
@@ -692,61 +1179,44 @@ string VanitySearch::GetExpectedTime(double keyRate,double keyCount) {
 
 // ----------------------------------------------------------------------------
 
-void VanitySearch::output(string addr,string pAddr,string pAddrHex) {
+void VanitySearch::output(const char *addr, Int &key, bool compressed) {
 
-#ifdef WIN64
-   WaitForSingleObject(ghMutex,INFINITE);
-#else
-  pthread_mutex_lock(&ghMutex);
-#endif
-
-  FILE *f = stdout;
-  bool needToClose = false;
+  char pAddr[WIF_MAX_LENGTH];
+  char pAddrHex[BASE16_MAX_LENGTH];
+  secp->GetPrivAddress(compressed, key, pAddr);
+  key.GetBase16(pAddrHex);
+  output(addr, pAddr, pAddrHex);
 
-  if (outputFile.length() > 0) {
-    f = fopen(outputFile.c_str(), "a");
-    if (f == NULL) {
-      printf("Cannot open %s for writing\n", outputFile.c_str());
-      f = stdout;
-    } else {
-      needToClose = true;
-    }
-  }
+}
 
-  if(!needToClose)
-    printf("\n");
+void VanitySearch::output(const char *addr, const char *pAddr, const char *pAddrHex) {
 
-  fprintf(f, "PubAddress: %s\n", addr.c_str());
+  // Formatted here, written by the result writer thread
+  char text[RESULT_MAX_LENGTH];
+  int l = sprintf(text, "PubAddress: %s\n", addr);
 
   if (startPubKeySpecified) {
 
-    fprintf(f, "PartialPriv: %s\n", pAddr.c_str());
+    sprintf(text + l, "PartialPriv: %s\n", pAddr);
 
   } else {
 
     switch (searchType) {
     case P2PKH:
-      fprintf(f, "Priv (WIF): p2pkh:%s\n", pAddr.c_str());
+      l += sprintf(text + l, "Priv (WIF): p2pkh:%s\n", pAddr);
       break;
     case P2SH:
-      fprintf(f, "Priv (WIF): p2wpkh-p2sh:%s\n", pAddr.c_str());
+      l += sprintf(text + l, "Priv (WIF): p2wpkh-p2sh:%s\n", pAddr);
       break;
     case BECH32:
-      fprintf(f, "Priv (WIF): p2wpkh:%s\n", pAddr.c_str());
+      l += sprintf(text + l, "Priv (WIF): p2wpkh:%s\n", pAddr);
       break;
     }
-    fprintf(f, "Priv (HEX): 0x%s\n", pAddrHex.c_str());
+    sprintf(text + l, "Priv (HEX): 0x%s\n", pAddrHex);
 
   }
 
-  if(needToClose)
-    fclose(f);
-
-#ifdef WIN64
-  ReleaseMutex(ghMutex);
-#else
-  pthread_mutex_unlock(&ghMutex);
-#endif
+  writer->Push(text);
 
 }
 
@@ -766,6 +1236,18 @@ void VanitySearch::updateFound() {
       }
       endOfSearch = allFound;
 
+    } else if (targetFile) {
+
+      endOfSearch = (targetFile->nbFound == targetFile->nbHash);
+
+    } else if (xTargets) {
+
+      endOfSearch = (xTargets->nbFound == xTargets->nbTarget);
+
+    } else if (zeroBits > 0) {
+
+      endOfSearch = true;
+
     } else {
 
       bool allFound = true;
@@ -795,167 +1277,291 @@ void VanitySearch::updateFound() {
 
 // ----------------------------------------------------------------------------
 
-bool VanitySearch::checkPrivKey(string addr, Int &key, int32_t incr, int endomorphism, bool mode) {
+void VanitySearch::getAddress(Point &p, bool compressed, char *addr) {
 
-  Int k(&key);
-  Point sp = startPubKey;
+  if (searchType == NOSTR_NPUB)
+    secp->GetNostrNpub(p, addr);
+  else if (searchType == NOSTR_HEX)
+    secp->GetNostrHex(p, addr);
+  else
+    secp->GetAddress(searchType, compressed, p, addr);
 
-  if (incr < 0) {
-    k.Add((uint64_t)(-incr));
-    k.Neg();
-    k.Add(&secp->order);
-    if (startPubKeySpecified) sp.y.ModNeg();
-  } else {
-    k.Add((uint64_t)incr);
-  }
-
-  // Endomorphisms
-  switch (endomorphism) {
-  case 1:
-    k.ModMulK1order(&lambda);
-    if(startPubKeySpecified) sp.x.ModMulK1(&beta);
-    break;
-  case 2:
-    k.ModMulK1order(&lambda2);
-    if (startPubKeySpecified) sp.x.ModMulK1(&beta2);
-    break;
-  }
-
-  // Check addresses
-  Point p = secp->ComputePublicKey(&k);
-  if (startPubKeySpecified) p = secp->AddDirect(p, sp);
-
-  string chkAddr = secp->GetNostrNpub(p);
-  if (chkAddr != addr) {
-
-    //Key may be the opposite one (negative zero or compressed key)
-    k.Neg();
-    k.Add(&secp->order);
-    p = secp->ComputePublicKey(&k);
-    if (startPubKeySpecified) {
-      sp.y.ModNeg();
-      p = secp->AddDirect(p, sp);
-    }
-    string chkAddr = secp->GetNostrNpub(p);
-    if (chkAddr != addr) {
-      vs_debug_logf("[checkPrivKey] WARNING wrong private key! addr='%s' chk='%s' endo=%d incr=%d comp=%d\n",
-                    addr.c_str(), chkAddr.c_str(), endomorphism, incr, (int)mode);
-      return false;
-    }
+}
+
+// ----------------------------------------------------------------------------
+
+void VanitySearch::checkPrivKey(const char *addr, Int &key, int32_t incr, int endomorphism, bool mode,
+                                bool *found, int64_t target, bool counted) {
+
+  // Random keys of the group size calibration
+  if (calibrating)
+    return;
 
+  // Keys past the end of the keyspace (rest of the last chunk or GPU block)
+  // belong to the next shard
+  if (keyBounded) {
+    Int w(&key);
+    w.Add((uint64_t)((incr < 0) ? -incr : incr));
+    if (w.IsGreaterOrEqual(&keyEnd))
+      return;
   }
 
-  output(addr, secp->GetPrivAddress(mode ,k), k.GetBase16());
+  // The hit is queued, the verifier thread confirms the key, outputs it and
+  // counts it
+  if (threadStat) threadStat->hits++;
+  HIT_ITEM h;
+  h.key.Set(&key);
+  h.incr = incr;
+  h.endomorphism = endomorphism;
+  h.mode = mode;
+  strncpy(h.addr, addr, ADDRESS_MAX_LENGTH - 1);
+  h.addr[ADDRESS_MAX_LENGTH - 1] = 0;
+  h.found = found;
+  h.target = target;
+  h.counted = counted;
 
-  return true;
+#ifdef WIN64
+  WaitForSingleObject(hitMutex, INFINITE);
+  while (hits.size() >= HIT_QUEUE_SIZE && verifierRunning) {
+    ReleaseMutex(hitMutex);
+    Timer::SleepMillis(1);
+    WaitForSingleObject(hitMutex, INFINITE);
+  }
+  hits.push_back(h);
+  nbHitQueued++;
+  ReleaseMutex(hitMutex);
+#else
+  pthread_mutex_lock(&hitMutex);
+  while (hits.size() >= HIT_QUEUE_SIZE && verifierRunning) {
+    pthread_mutex_unlock(&hitMutex);
+    Timer::SleepMillis(1);
+    pthread_mutex_lock(&hitMutex);
+  }
+  hits.push_back(h);
+  nbHitQueued++;
+  pthread_mutex_unlock(&hitMutex);
+#endif
 
 }
 
-void VanitySearch::checkAddrSSE(uint8_t *h1, uint8_t *h2, uint8_t *h3, uint8_t *h4,
-                                int32_t incr1, int32_t incr2, int32_t incr3, int32_t incr4,
-                                Int &key, int endomorphism, bool mode) {
-
-  // For Nostr, we need to compute public keys from incremented private keys
-  Int k1, k2, k3, k4;
-  k1.Set(&key); k1.Add(incr1);
-  k2.Set(&key); k2.Add(incr2);
-  k3.Set(&key); k3.Add(incr3);
-  k4.Set(&key); k4.Add(incr4);
-  
-  Point p1 = secp->ComputePublicKey(&k1);
-  Point p2 = secp->ComputePublicKey(&k2);
-  Point p3 = secp->ComputePublicKey(&k3);
-  Point p4 = secp->ComputePublicKey(&k4);
-  
-  vector<string> addr = secp->GetNostrNpub(p1, p2, p3, p4);
+void VanitySearch::verifyHits(HIT_ITEM *h, int nbHit) {
 
-  for (int i = 0; i < (int)inputPrefixes.size(); i++) {
+  Int k[HIT_BATCH_SIZE];
+  Int zi[HIT_BATCH_SIZE];
+  Point p[HIT_BATCH_SIZE];
 
-    if (Wildcard::match(addr[0].c_str(), inputPrefixes[i].c_str(), caseSensitive)) {
+  for (int i = 0; i < nbHit; i++) {
 
-      // Found it !
-      //*((*pi)[i].found) = true;
-      if (checkPrivKey(addr[0], k1, incr1, endomorphism, mode)) {
-        nbFoundKey++;
-        patternFound[i] = true;
-        updateFound();
-      }
+    Point sp = startPubKey;
+    k[i].Set(&h[i].key);
 
+    if (h[i].incr < 0) {
+      k[i].Add((uint64_t)(-h[i].incr));
+      k[i].Neg();
+      k[i].Add(&secp->order);
+      if (startPubKeySpecified) sp.y.ModNeg();
+    } else {
+      k[i].Add((uint64_t)h[i].incr);
     }
 
-    if (Wildcard::match(addr[1].c_str(), inputPrefixes[i].c_str(), caseSensitive)) {
-
-      // Found it !
-      //*((*pi)[i].found) = true;
-      if (checkPrivKey(addr[1], k2, 0, endomorphism, mode)) {
-        nbFoundKey++;
-        patternFound[i] = true;
-        updateFound();
-      }
-
+    // Endomorphisms
+    switch (h[i].endomorphism) {
+    case 1:
+      k[i].ModMulK1order(&lambda);
+      if (startPubKeySpecified) sp.x.ModMulK1(&beta);
+      break;
+    case 2:
+      k[i].ModMulK1order(&lambda2);
+      if (startPubKeySpecified) sp.x.ModMulK1(&beta2);
+      break;
     }
 
-    if (Wildcard::match(addr[2].c_str(), inputPrefixes[i].c_str(), caseSensitive)) {
+    // Projective points, one inversion for the batch
+    p[i] = secp->ComputePublicKey(&k[i], false);
+    if (startPubKeySpecified) p[i] = secp->Add(p[i], sp);
+    zi[i].Set(&p[i].z);
+
+  }
+
+  IntGroup grp(nbHit);
+  grp.Set(zi);
+  grp.ModInv();
 
-      // Found it !
-      //*((*pi)[i].found) = true;
-      if (checkPrivKey(addr[2], k3, 0, endomorphism, mode)) {
-        nbFoundKey++;
-        patternFound[i] = true;
-        updateFound();
+  for (int i = 0; i < nbHit; i++) {
+
+    p[i].x.ModMulK1(&zi[i]);
+    p[i].y.ModMulK1(&zi[i]);
+    p[i].z.SetInt32(1);
+
+    // Check addresses
+    char chkAddr[ADDRESS_MAX_LENGTH];
+    getAddress(p[i], h[i].mode, chkAddr);
+    if (strcmp(chkAddr, h[i].addr) != 0) {
+
+      //Key may be the opposite one (negative zero or compressed key)
+      //(-k).G + (-sp) = -(k.G + sp), the point is reused with y negated
+      k[i].Neg();
+      k[i].Add(&secp->order);
+      p[i].y.ModNeg();
+      getAddress(p[i], h[i].mode, chkAddr);
+      if (strcmp(chkAddr, h[i].addr) != 0) {
+        vs_debug_logf("[verifyHits] WARNING wrong private key! addr='%s' chk='%s' endo=%d incr=%d comp=%d\n",
+                      h[i].addr, chkAddr, h[i].endomorphism, h[i].incr, (int)h[i].mode);
+        continue;
       }
 
     }
 
-    if (Wildcard::match(addr[3].c_str(), inputPrefixes[i].c_str(), caseSensitive)) {
+    output(h[i].addr, k[i], h[i].mode);
 
-      // Found it !
-      //*((*pi)[i].found) = true;
-      if (checkPrivKey(addr[3], k4, 0, endomorphism, mode)) {
-        nbFoundKey++;
-        patternFound[i] = true;
-        updateFound();
+    // Only verified keys are found, -stop and the counters see them here
+    if (h[i].found)
+      *(h[i].found) = true;
+    if (h[i].target >= 0) {
+      uint8_t *tFound = targetFile ? targetFile->found : xTargets->found;
+      if (!tFound[h[i].target]) {
+        tFound[h[i].target] = 1;
+        if (targetFile) targetFile->nbFound++;
+        else xTargets->nbFound++;
       }
+    }
+    if (h[i].counted) {
+      nbFoundKey++;
+      updateFound();
+    }
 
+  }
+
+}
+
+// Verifier thread, drains the hit queue until the search threads are done
+void VanitySearch::VerifyHits() {
+
+  vector<HIT_ITEM> batch;
+  bool last = false;
+
+  while (!last) {
+
+#ifdef WIN64
+    WaitForSingleObject(hitMutex, INFINITE);
+    batch.swap(hits);
+    last = endOfHits;
+    ReleaseMutex(hitMutex);
+#else
+    pthread_mutex_lock(&hitMutex);
+    batch.swap(hits);
+    last = endOfHits;
+    pthread_mutex_unlock(&hitMutex);
+#endif
+
+    if (batch.empty()) {
+      if (!last) Timer::SleepMillis(1);
+      continue;
     }
 
+    for (int i = 0; i < (int)batch.size(); i += HIT_BATCH_SIZE)
+      verifyHits(batch.data() + i, min(HIT_BATCH_SIZE, (int)batch.size() - i));
+    nbHitDone += batch.size();
+    batch.clear();
+
   }
 
+  verifierRunning = false;
 
 }
 
+// Table kinds are called for the hash160 whose prefix has items only,
+// pattern kinds for every hash160
+#define CHECK_IS_PATTERN(kind) ((kind) == CPU_CHECK_PATTERN || (kind) == CPU_CHECK_BECH32)
+
+template<int KIND>
 void VanitySearch::checkAddr(int prefIdx, uint8_t *hash160, Int &key, int32_t incr, int endomorphism, bool mode) {
 
-  if (hasPattern) {
+  if (KIND == CPU_CHECK_PATTERN) {
 
-    // Wildcard search
-    string addr = secp->GetAddress(searchType, mode, hash160);
+    // Wildcard search, the address is fully encoded only when the leading
+    // characters reach a complete pattern head
+    unsigned char payload[25];
+    payload[0] = base58Version;
+    memcpy(payload + 1, hash160, 20);
+    sha256_checksum(payload, 21, payload + 21);
 
-    for (int i = 0; i < (int)inputPrefixes.size(); i++) {
+    Base58Leading lead;
+    lead.Set(payload);
+    char addr[64];
+    addr[0] = 0;
 
-      if (Wildcard::match(addr.c_str(), inputPrefixes[i].c_str(), caseSensitive)) {
+    // One walk of the pattern automaton for all patterns
+    int32_t state = 0;
+    while (state >= 0) {
+
+      int nbAccept;
+      const int32_t *acc = patterns.Accept(state, &nbAccept);
+      for (int j = 0; j < nbAccept; j++) {
+
+        int i = acc[j];
+        if (addr[0] == 0)
+          EncodeBase58(payload, payload + 25, addr);
+
+        if (Wildcard::match(addr, inputPrefixes[i].c_str(), caseSensitive)) {
+
+          checkPrivKey(addr, key, incr, endomorphism, mode, &patternFound[i]);
 
-        // Found it !
-        //*((*pi)[i].found) = true;
-        if (checkPrivKey(addr, key, incr, endomorphism, mode)) {
-          nbFoundKey++;
-          patternFound[i] = true;
-          updateFound();
         }
 
       }
 
+      if (patterns.Done(state))
+        break;
+      char c = lead.Next();
+      if (c == 0)
+        break;
+      state = patterns.Next(state, c);
+
     }
 
-    return;
+  } else if (KIND == CPU_CHECK_BECH32) {
 
-  }
+    // Wildcard search, hash160 bits fixed by the patterns are checked first
+    char addr[ADDRESS_MAX_LENGTH];
+    addr[0] = 0;
 
-  vector<PREFIX_ITEM> *pi = prefixes[prefIdx].items;
+    for (int i = 0; i < (int)inputPrefixes.size(); i++) {
 
-  if (onlyFull) {
+      if (!Bech32Pattern::Match(bech32Masks[i], hash160))
+        continue;
+      if (addr[0] == 0)
+        secp->GetAddress(BECH32, mode, hash160, addr);
+
+      if (Wildcard::match(addr, inputPrefixes[i].c_str(), caseSensitive)) {
+
+        checkPrivKey(addr, key, incr, endomorphism, mode, &patternFound[i]);
+
+      }
+
+    }
+
+  } else if (KIND == CPU_CHECK_TARGET) {
+
+    // Second level lookup, then the binary hash160 list
+    if (!PrefixLookup::Find(prefixes[prefIdx].lPrefixes, prefixes[prefIdx].nbLPrefix, *(prefixl_t *)hash160))
+      return;
+
+    int64_t idx = targetFile->Find(hash160);
+    if (idx < 0 || (stopWhenFound && targetFile->found[idx]))
+      return;
+    char addr[ADDRESS_MAX_LENGTH];
+    secp->GetAddress(searchType, mode, hash160, addr);
+    checkPrivKey(addr, key, incr, endomorphism, mode, NULL, idx);
+
+  } else if (KIND == CPU_CHECK_FULL) {
+
+    // Second level lookup
+    if (!PrefixLookup::Find(prefixes[prefIdx].lPrefixes, prefixes[prefIdx].nbLPrefix, *(prefixl_t *)hash160))
+      return;
 
     // Full addresses
+    vector<PREFIX_ITEM> *pi = prefixes[prefIdx].items;
     for (int i = 0; i < (int)pi->size(); i++) {
 
       if (stopWhenFound && *((*pi)[i].found))
@@ -964,12 +1570,9 @@ void VanitySearch::checkAddr(int prefIdx, uint8_t *hash160, Int &key, int32_t in
       if (ripemd160_comp_hash((*pi)[i].hash160, hash160)) {
 
         // Found it !
-        *((*pi)[i].found) = true;
-        // You believe it ?
-        if (checkPrivKey(secp->GetAddress(searchType, mode, hash160), key, incr, endomorphism, mode)) {
-          nbFoundKey++;
-          updateFound();
-        }
+        char addr[ADDRESS_MAX_LENGTH];
+        secp->GetAddress(searchType, mode, hash160, addr);
+        checkPrivKey(addr, key, incr, endomorphism, mode, (*pi)[i].found);
 
       }
 
@@ -977,27 +1580,28 @@ void VanitySearch::checkAddr(int prefIdx, uint8_t *hash160, Int &key, int32_t in
 
   } else {
 
-
-    char a[64];
-
-    string addr = secp->GetAddress(searchType, mode, hash160);
+    // Encoded only when needed, interval items reject most keys before
+    vector<PREFIX_ITEM> *pi = prefixes[prefIdx].items;
+    char addr[ADDRESS_MAX_LENGTH];
+    int addrLength = 0;
 
     for (int i = 0; i < (int)pi->size(); i++) {
 
       if (stopWhenFound && *((*pi)[i].found))
         continue;
 
-      strncpy(a, addr.c_str(), (*pi)[i].prefixLength);
-      a[(*pi)[i].prefixLength] = 0;
+      if ((*pi)[i].nbRange > 0 && !Base58Range::Match((*pi)[i].ranges, (*pi)[i].nbRange, hash160))
+        continue;
 
-      if (strcmp((*pi)[i].prefix, a) == 0) {
+      if (addrLength == 0)
+        addrLength = secp->GetAddress(searchType, mode, hash160, addr);
+
+      // Prefixes are not null terminated when they come from a mapped file
+      if (addrLength >= (*pi)[i].prefixLength &&
+          prefixMatch((*pi)[i].prefix, (*pi)[i].prefixLength, addr)) {
 
         // Found it !
-        *((*pi)[i].found) = true;
-        if (checkPrivKey(addr, key, incr, endomorphism, mode)) {
-          nbFoundKey++;
-          updateFound();
-        }
+        checkPrivKey(addr, key, incr, endomorphism, mode, (*pi)[i].found);
 
       }
 
@@ -1032,10 +1636,23 @@ void *_FindKey(void *lpParam) {
   }
 #endif
   
+  // Pinned before FindKeyCPU() allocates its state
+  if (p->cpu >= 0 && !CpuTopology::Pin(p->cpu))
+    p->node = -1;
+
   p->obj->FindKeyCPU(p);
   return 0;
 }
 
+#ifdef WIN64
+DWORD WINAPI _VerifyHits(LPVOID lpParam) {
+#else
+void *_VerifyHits(void *lpParam) {
+#endif
+  ((VanitySearch *)lpParam)->VerifyHits();
+  return 0;
+}
+
 #ifdef WIN64
 DWORD WINAPI _FindKeyGPU(LPVOID lpParam) {
 #else
@@ -1048,186 +1665,214 @@ void *_FindKeyGPU(void *lpParam) {
 
 // ----------------------------------------------------------------------------
 
-void VanitySearch::checkAddresses(bool compressed, Int key, int i, Point p1) {
+void VanitySearch::checkHex(Int &key, int i, Point &p) {
 
-  unsigned char h0[20];
-  Point pte1[1];
-  Point pte2[1];
+  // X of the point and of its two endomorphism images, -P shares X with P
+  Int x[3];
+  x[0].Set(&p.x);
+  x[1].ModMulK1(&p.x, &beta);
+  x[2].ModMulK1(&p.x, &beta2);
 
-  // Nostr npub handling: compare by npub prefix (after stripping constant 'npub1')
-  if (searchType == NOSTR_NPUB) {
-    string addr = secp->GetNostrNpub(p1);
-    // Extract data-dependent suffix from generated npub (drop leading "npub1")
-    const char *full = addr.c_str();
-    const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
+  for (int e = 0; e < 3; e++) {
+    for (int j = 0; j < (int)hexMasks.size(); j++) {
 
+      if (!HexPattern::Match(hexMasks[j], x[e].bits64) || (stopWhenFound && patternFound[j]))
+        continue;
 
+      Point pe;
+      pe.x.Set(&x[e]);
+      pe.y.Set(&p.y);
+      char addr[XHEX_MAX_LENGTH];
+      secp->GetNostrHex(pe, addr);
+      checkPrivKey(addr, key, i, e, true, &patternFound[j]);
+      break;
 
-    for (int idx = 0; idx < (int)inputPrefixes.size(); idx++) {
-      const string &rawPref = inputPrefixes[idx];
-      // Normalize user prefix: allow with or without leading "npub"/"npub1"
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) {
-        p += 4;
-        if (*p == '1') p++;
-      }
-      
-      // DEBUG (file): Log the pattern matching
-      vs_debug_logf("[checkAddresses] compare suffix='%s' pattern='%s' full='%s'\n", npubSuffix, p, full);
-      
-      // Compare user suffix as prefix of generated suffix
-      if ((int)strlen(p) <= (int)strlen(npubSuffix) && bech32_match_wildcard_prefix(npubSuffix, p)) {
-        vs_debug_logf("[checkAddresses] MATCH npub='%s' pattern='%s' (CPU path)\n", full, rawPref.c_str());
-        // 直接出力して終了（Nostrでは後続の分岐はコスト重いのでスキップ）
-        Int k_i(&key); k_i.Add((uint64_t)i);
-        output(addr, secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
     }
+  }
+
+}
+
+// ----------------------------------------------------------------------------
+
+static inline int leadingZeroBits(const uint64_t *x) {
+
+  for (int i = 3; i >= 0; i--)
+    if (x[i])
+      return (3 - i) * 64 + (int)LZC(x[i]);
+  return 256;
+
+}
+
+void VanitySearch::checkZeroBits(Int &key, int i, Point &p) {
+
+  // One comparison per X while nothing better than the current best
+  Int x[3];
+  x[0].Set(&p.x);
+  x[1].ModMulK1(&p.x, &beta);
+  x[2].ModMulK1(&p.x, &beta2);
+  if (x[0].bits64[3] >= zeroLimit && x[1].bits64[3] >= zeroLimit && x[2].bits64[3] >= zeroLimit)
     return;
-  } else {
-    // Point (Bitcoin address search path)
-    secp->GetHash160(searchType, compressed, p1, h0);
-    prefix_t pr0 = *(prefix_t *)h0;
-    if (hasPattern || prefixes[pr0].items)
-      checkAddr(pr0, h0, key, i, 0, compressed);
+
+  for (int e = 0; e < 3; e++) {
+
+    int nbBit = leadingZeroBits(x[e].bits64);
+    if (nbBit <= zeroBest)
+      continue;
+
+    // The best is compared again under the lock, another thread may have
+    // reached it since
+#ifdef WIN64
+    WaitForSingleObject(hitMutex, INFINITE);
+#else
+    pthread_mutex_lock(&hitMutex);
+#endif
+    bool better = (nbBit > zeroBest);
+    if (better) {
+      zeroBest = nbBit;
+      zeroLimit = (nbBit >= 63) ? 1 : (1ULL << (63 - nbBit));
+    }
+#ifdef WIN64
+    ReleaseMutex(hitMutex);
+#else
+    pthread_mutex_unlock(&hitMutex);
+#endif
+    if (!better || nbBit < zeroFloor)
+      continue;
+
+    Point pe;
+    pe.x.Set(&x[e]);
+    pe.y.Set(&p.y);
+    char addr[XHEX_MAX_LENGTH];
+    secp->GetNostrHex(pe, addr);
+    checkPrivKey(addr, key, i, e, true, NULL, -1, nbBit >= zeroBits);
+
+  }
+
+}
+
+// ----------------------------------------------------------------------------
+
+void VanitySearch::checkNpub(Int &key, int i, Point &p) {
+
+  char addr[NPUB_MAX_LENGTH];
+  secp->GetNostrNpub(p, addr);
+  checkNpub(key, i, addr);
+
+}
+
+void VanitySearch::checkNpub(Int &key, int i, const char *addr) {
+
+  const char *suffix = (strncmp(addr, "npub1", 5) == 0) ? (addr + 5) : addr;
+  size_t ls = strlen(suffix);
+
+  for (int j = 0; j < (int)npubSuffixes.size(); j++) {
+    if (npubSuffixes[j].length() <= ls && bech32_match_wildcard_prefix(suffix, npubSuffixes[j].c_str())) {
+      checkPrivKey(addr, key, i, 0, true);
+      break;
+    }
   }
 
+}
+
+void VanitySearch::checkXTarget(Int &key, int i, Point &p) {
+
+  // Exact targets, npub is built only on a hit
+  int64_t idx = xTargets->Find(&p.x);
+  if (idx < 0 || (stopWhenFound && xTargets->found[idx]))
+    return;
+  char addr[NPUB_MAX_LENGTH];
+  secp->GetNostrNpub(p, addr);
+  checkPrivKey(addr, key, i, 0, true, NULL, idx);
+
+}
+
+// ----------------------------------------------------------------------------
+
+template<int KIND, bool COMPRESSED>
+void VanitySearch::checkAddresses(Int &key, int i, Point p1) {
+
+  unsigned char h0[20];
+  Point pte1[1];
+  Point pte2[1];
+  prefix_t pr0;
+
+  // Point
+  secp->GetHash160(searchType, COMPRESSED, p1, h0);
+  pr0 = *(prefix_t *)h0;
+  if (CHECK_IS_PATTERN(KIND) || prefixes[pr0].items)
+    checkAddr<KIND>(pr0, h0, key, i, 0, COMPRESSED);
+
   // Endomorphism #1
   pte1[0].x.ModMulK1(&p1.x, &beta);
   pte1[0].y.Set(&p1.y);
 
-  if (searchType == NOSTR_NPUB) {
-    string addr = secp->GetNostrNpub(pte1[0]);
-    const char *full = addr.c_str();
-    const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
-    for (int idx = 0; idx < (int)inputPrefixes.size(); idx++) {
-      const string &rawPref = inputPrefixes[idx];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      if ((int)strlen(p) <= (int)strlen(npubSuffix) && bech32_match_wildcard_prefix(npubSuffix, p)) {
-        vs_debug_logf("[checkAddresses] endo#1 match npub='%s' pattern='%s'\n", full, rawPref.c_str());
-        Int k_i(&key); k_i.Add((uint64_t)i);
-        output(addr, secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-    }
-    return;
-  } else {
-    secp->GetHash160(searchType, compressed, pte1[0], h0);
-    prefix_t pr0 = *(prefix_t *)h0;
-    if (hasPattern || prefixes[pr0].items)
-      checkAddr(pr0, h0, key, i, 1, compressed);
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte1[0], h0);
+  pr0 = *(prefix_t *)h0;
+  if (CHECK_IS_PATTERN(KIND) || prefixes[pr0].items)
+    checkAddr<KIND>(pr0, h0, key, i, 1, COMPRESSED);
 
   // Endomorphism #2
   pte2[0].x.ModMulK1(&p1.x, &beta2);
   pte2[0].y.Set(&p1.y);
 
-  if (searchType == NOSTR_NPUB) {
-    string addr = secp->GetNostrNpub(pte2[0]);
-    const char *full = addr.c_str();
-    const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
-    for (int idx = 0; idx < (int)inputPrefixes.size(); idx++) {
-      const string &rawPref = inputPrefixes[idx];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      if ((int)strlen(p) <= (int)strlen(npubSuffix) && bech32_match_wildcard_prefix(npubSuffix, p)) {
-        vs_debug_logf("[checkAddresses] endo#2 match npub='%s' pattern='%s'\n", full, rawPref.c_str());
-        Int k_i(&key); k_i.Add((uint64_t)i);
-        output(addr, secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-    }
-    return;
-  } else {
-    secp->GetHash160(searchType, compressed, pte2[0], h0);
-    prefix_t pr0 = *(prefix_t *)h0;
-    if (hasPattern || prefixes[pr0].items)
-      checkAddr(pr0, h0, key, i, 2, compressed);
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte2[0], h0);
+  pr0 = *(prefix_t *)h0;
+  if (CHECK_IS_PATTERN(KIND) || prefixes[pr0].items)
+    checkAddr<KIND>(pr0, h0, key, i, 2, COMPRESSED);
 
   // Curve symetrie
   // if (x,y) = k*G, then (x, -y) is -k*G
   p1.y.ModNeg();
-  if (searchType == NOSTR_NPUB) {
-    string addr = secp->GetNostrNpub(p1);
-    const char *full = addr.c_str();
-    const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
-    for (int idx = 0; idx < (int)inputPrefixes.size(); idx++) {
-      const string &rawPref = inputPrefixes[idx];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      if ((int)strlen(p) <= (int)strlen(npubSuffix) && bech32_match_wildcard_prefix(npubSuffix, p)) {
-        vs_debug_logf("[checkAddresses] sym match npub='%s' pattern='%s'\n", full, rawPref.c_str());
-        Int k_i(&key); k_i.Add((uint64_t)i);
-        output(addr, secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-    }
-    return;
-  } else {
-    secp->GetHash160(searchType, compressed, p1, h0);
-    prefix_t pr0 = *(prefix_t *)h0;
-    if (hasPattern || prefixes[pr0].items)
-      checkAddr(pr0, h0, key, -i, 0, compressed);
-  }
+  secp->GetHash160(searchType, COMPRESSED, p1, h0);
+  pr0 = *(prefix_t *)h0;
+  if (CHECK_IS_PATTERN(KIND) || prefixes[pr0].items)
+    checkAddr<KIND>(pr0, h0, key, -i, 0, COMPRESSED);
 
   // Endomorphism #1
   pte1[0].y.ModNeg();
-  if (searchType == NOSTR_NPUB) {
-    string addr = secp->GetNostrNpub(pte1[0]);
-    const char *full = addr.c_str();
-    const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
-    for (int idx = 0; idx < (int)inputPrefixes.size(); idx++) {
-      const string &rawPref = inputPrefixes[idx];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      if ((int)strlen(p) <= (int)strlen(npubSuffix) && bech32_match_wildcard_prefix(npubSuffix, p)) {
-        vs_debug_logf("[checkAddresses] sym endo#1 match npub='%s' pattern='%s'\n", full, rawPref.c_str());
-        Int k_i(&key); k_i.Add((uint64_t)i);
-        output(addr, secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-    }
-    return;
-  } else {
-    secp->GetHash160(searchType, compressed, pte1[0], h0);
-    prefix_t pr0 = *(prefix_t *)h0;
-    if (hasPattern || prefixes[pr0].items)
-      checkAddr(pr0, h0, key, -i, 1, compressed);
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte1[0], h0);
+  pr0 = *(prefix_t *)h0;
+  if (CHECK_IS_PATTERN(KIND) || prefixes[pr0].items)
+    checkAddr<KIND>(pr0, h0, key, -i, 1, COMPRESSED);
 
   // Endomorphism #2
   pte2[0].y.ModNeg();
-  if (searchType == NOSTR_NPUB) {
-    string addr = secp->GetNostrNpub(pte2[0]);
-    const char *full = addr.c_str();
-    const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
-    for (int idx = 0; idx < (int)inputPrefixes.size(); idx++) {
-      const string &rawPref = inputPrefixes[idx];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      if ((int)strlen(p) <= (int)strlen(npubSuffix) && bech32_match_wildcard_prefix(npubSuffix, p)) {
-        vs_debug_logf("[checkAddresses] sym endo#2 match npub='%s' pattern='%s'\n", full, rawPref.c_str());
-        Int k_i(&key); k_i.Add((uint64_t)i);
-        output(addr, secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-    }
-    return;
-  } else {
-    secp->GetHash160(searchType, compressed, pte2[0], h0);
-    prefix_t pr0 = *(prefix_t *)h0;
-    if (hasPattern || prefixes[pr0].items)
-      checkAddr(pr0, h0, key, -i, 2, compressed);
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte2[0], h0);
+  pr0 = *(prefix_t *)h0;
+  if (CHECK_IS_PATTERN(KIND) || prefixes[pr0].items)
+    checkAddr<KIND>(pr0, h0, key, -i, 2, COMPRESSED);
 
 }
 
 // ----------------------------------------------------------------------------
 
-void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, Point p2, Point p3, Point p4) {
+template<int KIND>
+void VanitySearch::checkHash160SSE(uint8_t *h0, uint8_t *h1, uint8_t *h2, uint8_t *h3,
+                                   int i, int32_t sign, Int &key, int endomorphism, bool mode) {
+
+  // Keys i..i+3, opposite keys when sign is -1. Patterns are checked on
+  // each lane, the prefix table is not used.
+  if (CHECK_IS_PATTERN(KIND)) {
+    checkAddr<KIND>(0, h0, key, sign * i, endomorphism, mode);
+    checkAddr<KIND>(0, h1, key, sign * (i + 1), endomorphism, mode);
+    checkAddr<KIND>(0, h2, key, sign * (i + 2), endomorphism, mode);
+    checkAddr<KIND>(0, h3, key, sign * (i + 3), endomorphism, mode);
+    return;
+  }
+
+  prefix_t pr0 = *(prefix_t *)h0;
+  prefix_t pr1 = *(prefix_t *)h1;
+  prefix_t pr2 = *(prefix_t *)h2;
+  prefix_t pr3 = *(prefix_t *)h3;
+  if (prefixes[pr0].items) checkAddr<KIND>(pr0, h0, key, sign * i, endomorphism, mode);
+  if (prefixes[pr1].items) checkAddr<KIND>(pr1, h1, key, sign * (i + 1), endomorphism, mode);
+  if (prefixes[pr2].items) checkAddr<KIND>(pr2, h2, key, sign * (i + 2), endomorphism, mode);
+  if (prefixes[pr3].items) checkAddr<KIND>(pr3, h3, key, sign * (i + 3), endomorphism, mode);
+
+}
+
+template<int KIND, bool COMPRESSED>
+void VanitySearch::checkAddressesSSE(Int &key, int i, Point p1, Point p2, Point p3, Point p4) {
 
   unsigned char h0[20];
   unsigned char h1[20];
@@ -1235,79 +1880,10 @@ void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, P
   unsigned char h3[20];
   Point pte1[4];
   Point pte2[4];
-  prefix_t pr0;
-  prefix_t pr1;
-  prefix_t pr2;
-  prefix_t pr3;
 
   // Point -------------------------------------------------------------------------
-  if (searchType == NOSTR_NPUB) {
-    vector<string> addr = secp->GetNostrNpub(p1, p2, p3, p4);
-    // Reconstruct private keys for contiguous indices relative to base 'key'
-    Int k_i(&key);   k_i.Add((uint64_t)i);
-    Int k_i1(&key);  k_i1.Add((uint64_t)(i + 1));
-    Int k_i2(&key);  k_i2.Add((uint64_t)(i + 2));
-    Int k_i3(&key);  k_i3.Add((uint64_t)(i + 3));
-    const char *s0 = addr[0].c_str(); const char *t0 = (addr[0].rfind("npub1", 0) == 0) ? (s0 + 5) : s0;
-    const char *s1 = addr[1].c_str(); const char *t1 = (addr[1].rfind("npub1", 0) == 0) ? (s1 + 5) : s1;
-    const char *s2 = addr[2].c_str(); const char *t2 = (addr[2].rfind("npub1", 0) == 0) ? (s2 + 5) : s2;
-    const char *s3 = addr[3].c_str(); const char *t3 = (addr[3].rfind("npub1", 0) == 0) ? (s3 + 5) : s3;
-
-    for (int k = 0; k < (int)inputPrefixes.size(); k++) {
-      const string &rawPref = inputPrefixes[k];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      size_t lp = strlen(p);
-
-      if (lp <= strlen(t0) && bech32_match_wildcard_prefix(t0, p)) {
-        vs_debug_logf("[checkAddressesSSE] match t0 npub='%s' pattern='%s'\n", addr[0].c_str(), rawPref.c_str());
-        output(addr[0], secp->GetPrivAddress(compressed, k_i), k_i.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-      if (lp <= strlen(t1) && bech32_match_wildcard_prefix(t1, p)) { 
-        vs_debug_logf("[checkAddressesSSE] match t1 npub='%s' pattern='%s'\n", addr[1].c_str(), rawPref.c_str());
-        output(addr[1], secp->GetPrivAddress(compressed, k_i1), k_i1.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-      if (lp <= strlen(t2) && bech32_match_wildcard_prefix(t2, p)) { 
-        vs_debug_logf("[checkAddressesSSE] match t2 npub='%s' pattern='%s'\n", addr[2].c_str(), rawPref.c_str());
-        output(addr[2], secp->GetPrivAddress(compressed, k_i2), k_i2.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-      if (lp <= strlen(t3) && bech32_match_wildcard_prefix(t3, p)) { 
-        vs_debug_logf("[checkAddressesSSE] match t3 npub='%s' pattern='%s'\n", addr[3].c_str(), rawPref.c_str());
-        output(addr[3], secp->GetPrivAddress(compressed, k_i3), k_i3.GetBase16());
-        nbFoundKey++; updateFound();
-      }
-    }
-    // Nostr npub では、後続のエンドモルフィズム／対称点分岐は再検証コストが大きく、
-    // 正しい秘密鍵再構成の前提も異なるため実施しない
-    return;
-  } else {
-    secp->GetHash160(searchType, compressed, p1, p2, p3, p4, h0, h1, h2, h3);
-
-    if (!hasPattern) {
-
-      pr0 = *(prefix_t *)h0;
-      pr1 = *(prefix_t *)h1;
-      pr2 = *(prefix_t *)h2;
-      pr3 = *(prefix_t *)h3;
-
-      if (prefixes[pr0].items)
-        checkAddr(pr0, h0, key, i, 0, compressed);
-      if (prefixes[pr1].items)
-        checkAddr(pr1, h1, key, i + 1, 0, compressed);
-      if (prefixes[pr2].items)
-        checkAddr(pr2, h2, key, i + 2, 0, compressed);
-      if (prefixes[pr3].items)
-        checkAddr(pr3, h3, key, i + 3, 0, compressed);
-
-    } else {
-
-      checkAddrSSE(h0, h1, h2, h3, i, i + 1, i + 2, i + 3, key, 0, compressed);
-
-    }
-  }
+  secp->GetHash160(searchType, COMPRESSED, p1, p2, p3, p4, h0, h1, h2, h3);
+  checkHash160SSE<KIND>(h0, h1, h2, h3, i, 1, key, 0, COMPRESSED);
 
   // Endomorphism #1
   // if (x, y) = k * G, then (beta*x, y) = lambda*k*G
@@ -1320,34 +1896,8 @@ void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, P
   pte1[3].x.ModMulK1(&p4.x, &beta);
   pte1[3].y.Set(&p4.y);
 
-  if (searchType == NOSTR_NPUB) {
-    vector<string> addr = secp->GetNostrNpub(pte1[0], pte1[1], pte1[2], pte1[3]);
-    const char *s0 = addr[0].c_str(); const char *t0 = (addr[0].rfind("npub1", 0) == 0) ? (s0 + 5) : s0;
-    const char *s1 = addr[1].c_str(); const char *t1 = (addr[1].rfind("npub1", 0) == 0) ? (s1 + 5) : s1;
-    const char *s2 = addr[2].c_str(); const char *t2 = (addr[2].rfind("npub1", 0) == 0) ? (s2 + 5) : s2;
-    const char *s3 = addr[3].c_str(); const char *t3 = (addr[3].rfind("npub1", 0) == 0) ? (s3 + 5) : s3;
-    for (int k = 0; k < (int)inputPrefixes.size(); k++) {
-      const string &rawPref = inputPrefixes[k];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      size_t lp = strlen(p);
-      if (lp <= strlen(t0) && bech32_match_wildcard_prefix(t0, p)) { vs_debug_logf("[checkAddressesSSE] endo#1 t0 npub='%s' pattern='%s'\n", addr[0].c_str(), rawPref.c_str()); if (checkPrivKey(addr[0], key, i, 1, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t1) && bech32_match_wildcard_prefix(t1, p)) { vs_debug_logf("[checkAddressesSSE] endo#1 t1 npub='%s' pattern='%s'\n", addr[1].c_str(), rawPref.c_str()); if (checkPrivKey(addr[1], key, i + 1, 1, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t2) && bech32_match_wildcard_prefix(t2, p)) { vs_debug_logf("[checkAddressesSSE] endo#1 t2 npub='%s' pattern='%s'\n", addr[2].c_str(), rawPref.c_str()); if (checkPrivKey(addr[2], key, i + 2, 1, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t3) && bech32_match_wildcard_prefix(t3, p)) { vs_debug_logf("[checkAddressesSSE] endo#1 t3 npub='%s' pattern='%s'\n", addr[3].c_str(), rawPref.c_str()); if (checkPrivKey(addr[3], key, i + 3, 1, compressed)) { nbFoundKey++; updateFound(); } }
-    }
-  } else {
-    secp->GetHash160(searchType, compressed, pte1[0], pte1[1], pte1[2], pte1[3], h0, h1, h2, h3);
-    if (!hasPattern) {
-      pr0 = *(prefix_t *)h0; pr1 = *(prefix_t *)h1; pr2 = *(prefix_t *)h2; pr3 = *(prefix_t *)h3;
-      if (prefixes[pr0].items) checkAddr(pr0, h0, key, i, 1, compressed);
-      if (prefixes[pr1].items) checkAddr(pr1, h1, key, (i + 1), 1, compressed);
-      if (prefixes[pr2].items) checkAddr(pr2, h2, key, (i + 2), 1, compressed);
-      if (prefixes[pr3].items) checkAddr(pr3, h3, key, (i + 3), 1, compressed);
-    } else {
-      checkAddrSSE(h0, h1, h2, h3, i, i + 1, i + 2, i + 3, key, 1, compressed);
-    }
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte1[0], pte1[1], pte1[2], pte1[3], h0, h1, h2, h3);
+  checkHash160SSE<KIND>(h0, h1, h2, h3, i, 1, key, 1, COMPRESSED);
 
   // Endomorphism #2
   // if (x, y) = k * G, then (beta2*x, y) = lambda2*k*G
@@ -1360,34 +1910,8 @@ void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, P
   pte2[3].x.ModMulK1(&p4.x, &beta2);
   pte2[3].y.Set(&p4.y);
 
-  if (searchType == NOSTR_NPUB) {
-    vector<string> addr = secp->GetNostrNpub(pte2[0], pte2[1], pte2[2], pte2[3]);
-    const char *s0 = addr[0].c_str(); const char *t0 = (addr[0].rfind("npub1", 0) == 0) ? (s0 + 5) : s0;
-    const char *s1 = addr[1].c_str(); const char *t1 = (addr[1].rfind("npub1", 0) == 0) ? (s1 + 5) : s1;
-    const char *s2 = addr[2].c_str(); const char *t2 = (addr[2].rfind("npub1", 0) == 0) ? (s2 + 5) : s2;
-    const char *s3 = addr[3].c_str(); const char *t3 = (addr[3].rfind("npub1", 0) == 0) ? (s3 + 5) : s3;
-    for (int k = 0; k < (int)inputPrefixes.size(); k++) {
-      const string &rawPref = inputPrefixes[k];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      size_t lp = strlen(p);
-      if (lp <= strlen(t0) && bech32_match_wildcard_prefix(t0, p)) { vs_debug_logf("[checkAddressesSSE] endo#2 t0 npub='%s' pattern='%s'\n", addr[0].c_str(), rawPref.c_str()); if (checkPrivKey(addr[0], key, i, 2, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t1) && bech32_match_wildcard_prefix(t1, p)) { vs_debug_logf("[checkAddressesSSE] endo#2 t1 npub='%s' pattern='%s'\n", addr[1].c_str(), rawPref.c_str()); if (checkPrivKey(addr[1], key, (i + 1), 2, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t2) && bech32_match_wildcard_prefix(t2, p)) { vs_debug_logf("[checkAddressesSSE] endo#2 t2 npub='%s' pattern='%s'\n", addr[2].c_str(), rawPref.c_str()); if (checkPrivKey(addr[2], key, (i + 2), 2, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t3) && bech32_match_wildcard_prefix(t3, p)) { vs_debug_logf("[checkAddressesSSE] endo#2 t3 npub='%s' pattern='%s'\n", addr[3].c_str(), rawPref.c_str()); if (checkPrivKey(addr[3], key, (i + 3), 2, compressed)) { nbFoundKey++; updateFound(); } }
-    }
-  } else {
-    secp->GetHash160(searchType, compressed, pte2[0], pte2[1], pte2[2], pte2[3], h0, h1, h2, h3);
-    if (!hasPattern) {
-      pr0 = *(prefix_t *)h0; pr1 = *(prefix_t *)h1; pr2 = *(prefix_t *)h2; pr3 = *(prefix_t *)h3;
-      if (prefixes[pr0].items) checkAddr(pr0, h0, key, i, 2, compressed);
-      if (prefixes[pr1].items) checkAddr(pr1, h1, key, (i + 1), 2, compressed);
-      if (prefixes[pr2].items) checkAddr(pr2, h2, key, (i + 2), 2, compressed);
-      if (prefixes[pr3].items) checkAddr(pr3, h3, key, (i + 3), 2, compressed);
-    } else {
-      checkAddrSSE(h0, h1, h2, h3, i, i + 1, i + 2, i + 3, key, 2, compressed);
-    }
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte2[0], pte2[1], pte2[2], pte2[3], h0, h1, h2, h3);
+  checkHash160SSE<KIND>(h0, h1, h2, h3, i, 1, key, 2, COMPRESSED);
 
   // Curve symetrie -------------------------------------------------------------------------
   // if (x,y) = k*G, then (x, -y) is -k*G
@@ -1397,34 +1921,8 @@ void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, P
   p3.y.ModNeg();
   p4.y.ModNeg();
 
-  if (searchType == NOSTR_NPUB) {
-    vector<string> addr = secp->GetNostrNpub(p1, p2, p3, p4);
-    const char *s0 = addr[0].c_str(); const char *t0 = (addr[0].rfind("npub1", 0) == 0) ? (s0 + 5) : s0;
-    const char *s1 = addr[1].c_str(); const char *t1 = (addr[1].rfind("npub1", 0) == 0) ? (s1 + 5) : s1;
-    const char *s2 = addr[2].c_str(); const char *t2 = (addr[2].rfind("npub1", 0) == 0) ? (s2 + 5) : s2;
-    const char *s3 = addr[3].c_str(); const char *t3 = (addr[3].rfind("npub1", 0) == 0) ? (s3 + 5) : s3;
-    for (int k = 0; k < (int)inputPrefixes.size(); k++) {
-      const string &rawPref = inputPrefixes[k];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      size_t lp = strlen(p);
-      if (lp <= strlen(t0) && bech32_match_wildcard_prefix(t0, p)) { vs_debug_logf("[checkAddressesSSE] sym t0 npub='%s' pattern='%s'\n", addr[0].c_str(), rawPref.c_str()); if (checkPrivKey(addr[0], key, -i, 0, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t1) && bech32_match_wildcard_prefix(t1, p)) { vs_debug_logf("[checkAddressesSSE] sym t1 npub='%s' pattern='%s'\n", addr[1].c_str(), rawPref.c_str()); if (checkPrivKey(addr[1], key, -(i + 1), 0, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t2) && bech32_match_wildcard_prefix(t2, p)) { vs_debug_logf("[checkAddressesSSE] sym t2 npub='%s' pattern='%s'\n", addr[2].c_str(), rawPref.c_str()); if (checkPrivKey(addr[2], key, -(i + 2), 0, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t3) && bech32_match_wildcard_prefix(t3, p)) { vs_debug_logf("[checkAddressesSSE] sym t3 npub='%s' pattern='%s'\n", addr[3].c_str(), rawPref.c_str()); if (checkPrivKey(addr[3], key, -(i + 3), 0, compressed)) { nbFoundKey++; updateFound(); } }
-    }
-  } else {
-    secp->GetHash160(searchType, compressed, p1, p2, p3, p4, h0, h1, h2, h3);
-    if (!hasPattern) {
-      pr0 = *(prefix_t *)h0; pr1 = *(prefix_t *)h1; pr2 = *(prefix_t *)h2; pr3 = *(prefix_t *)h3;
-      if (prefixes[pr0].items) checkAddr(pr0, h0, key, -i, 0, compressed);
-      if (prefixes[pr1].items) checkAddr(pr1, h1, key, -(i + 1), 0, compressed);
-      if (prefixes[pr2].items) checkAddr(pr2, h2, key, -(i + 2), 0, compressed);
-      if (prefixes[pr3].items) checkAddr(pr3, h3, key, -(i + 3), 0, compressed);
-    } else {
-      checkAddrSSE(h0, h1, h2, h3, -i, -(i + 1), -(i + 2), -(i + 3), key, 0, compressed);
-    }
-  }
+  secp->GetHash160(searchType, COMPRESSED, p1, p2, p3, p4, h0, h1, h2, h3);
+  checkHash160SSE<KIND>(h0, h1, h2, h3, i, -1, key, 0, COMPRESSED);
 
   // Endomorphism #1
   // if (x, y) = k * G, then (beta*x, y) = lambda*k*G
@@ -1433,35 +1931,8 @@ void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, P
   pte1[2].y.ModNeg();
   pte1[3].y.ModNeg();
 
-
-  if (searchType == NOSTR_NPUB) {
-    vector<string> addr = secp->GetNostrNpub(pte1[0], pte1[1], pte1[2], pte1[3]);
-    const char *s0 = addr[0].c_str(); const char *t0 = (addr[0].rfind("npub1", 0) == 0) ? (s0 + 5) : s0;
-    const char *s1 = addr[1].c_str(); const char *t1 = (addr[1].rfind("npub1", 0) == 0) ? (s1 + 5) : s1;
-    const char *s2 = addr[2].c_str(); const char *t2 = (addr[2].rfind("npub1", 0) == 0) ? (s2 + 5) : s2;
-    const char *s3 = addr[3].c_str(); const char *t3 = (addr[3].rfind("npub1", 0) == 0) ? (s3 + 5) : s3;
-    for (int k = 0; k < (int)inputPrefixes.size(); k++) {
-      const string &rawPref = inputPrefixes[k];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      size_t lp = strlen(p);
-      if (lp <= strlen(t0) && bech32_match_wildcard_prefix(t0, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#1 t0 npub='%s' pattern='%s'\n", addr[0].c_str(), rawPref.c_str()); if (checkPrivKey(addr[0], key, -i, 1, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t1) && bech32_match_wildcard_prefix(t1, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#1 t1 npub='%s' pattern='%s'\n", addr[1].c_str(), rawPref.c_str()); if (checkPrivKey(addr[1], key, -(i + 1), 1, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t2) && bech32_match_wildcard_prefix(t2, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#1 t2 npub='%s' pattern='%s'\n", addr[2].c_str(), rawPref.c_str()); if (checkPrivKey(addr[2], key, -(i + 2), 1, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t3) && bech32_match_wildcard_prefix(t3, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#1 t3 npub='%s' pattern='%s'\n", addr[3].c_str(), rawPref.c_str()); if (checkPrivKey(addr[3], key, -(i + 3), 1, compressed)) { nbFoundKey++; updateFound(); } }
-    }
-  } else {
-    secp->GetHash160(searchType, compressed, pte1[0], pte1[1], pte1[2], pte1[3], h0, h1, h2, h3);
-    if (!hasPattern) {
-      pr0 = *(prefix_t *)h0; pr1 = *(prefix_t *)h1; pr2 = *(prefix_t *)h2; pr3 = *(prefix_t *)h3;
-      if (prefixes[pr0].items) checkAddr(pr0, h0, key, -i, 1, compressed);
-      if (prefixes[pr1].items) checkAddr(pr1, h1, key, -(i + 1), 1, compressed);
-      if (prefixes[pr2].items) checkAddr(pr2, h2, key, -(i + 2), 1, compressed);
-      if (prefixes[pr3].items) checkAddr(pr3, h3, key, -(i + 3), 1, compressed);
-    } else {
-      checkAddrSSE(h0, h1, h2, h3, -i, -(i + 1), -(i + 2), -(i + 3), key, 1, compressed);
-    }
-  }
+  secp->GetHash160(searchType, COMPRESSED, pte1[0], pte1[1], pte1[2], pte1[3], h0, h1, h2, h3);
+  checkHash160SSE<KIND>(h0, h1, h2, h3, i, -1, key, 1, COMPRESSED);
 
   // Endomorphism #2
   // if (x, y) = k * G, then (beta2*x, y) = lambda2*k*G
@@ -1470,75 +1941,274 @@ void VanitySearch::checkAddressesSSE(bool compressed,Int key, int i, Point p1, P
   pte2[2].y.ModNeg();
   pte2[3].y.ModNeg();
 
-  if (searchType == NOSTR_NPUB) {
-    vector<string> addr = secp->GetNostrNpub(pte2[0], pte2[1], pte2[2], pte2[3]);
-    const char *s0 = addr[0].c_str(); const char *t0 = (addr[0].rfind("npub1", 0) == 0) ? (s0 + 5) : s0;
-    const char *s1 = addr[1].c_str(); const char *t1 = (addr[1].rfind("npub1", 0) == 0) ? (s1 + 5) : s1;
-    const char *s2 = addr[2].c_str(); const char *t2 = (addr[2].rfind("npub1", 0) == 0) ? (s2 + 5) : s2;
-    const char *s3 = addr[3].c_str(); const char *t3 = (addr[3].rfind("npub1", 0) == 0) ? (s3 + 5) : s3;
-    for (int k = 0; k < (int)inputPrefixes.size(); k++) {
-      const string &rawPref = inputPrefixes[k];
-      const char *p = rawPref.c_str();
-      if (rawPref.rfind("npub", 0) == 0) { p += 4; if (*p == '1') p++; }
-      size_t lp = strlen(p);
-      if (lp <= strlen(t0) && bech32_match_wildcard_prefix(t0, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#2 t0 npub='%s' pattern='%s'\n", addr[0].c_str(), rawPref.c_str()); if (checkPrivKey(addr[0], key, -i, 2, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t1) && bech32_match_wildcard_prefix(t1, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#2 t1 npub='%s' pattern='%s'\n", addr[1].c_str(), rawPref.c_str()); if (checkPrivKey(addr[1], key, -(i + 1), 2, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t2) && bech32_match_wildcard_prefix(t2, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#2 t2 npub='%s' pattern='%s'\n", addr[2].c_str(), rawPref.c_str()); if (checkPrivKey(addr[2], key, -(i + 2), 2, compressed)) { nbFoundKey++; updateFound(); } }
-      if (lp <= strlen(t3) && bech32_match_wildcard_prefix(t3, p)) { vs_debug_logf("[checkAddressesSSE] sym endo#2 t3 npub='%s' pattern='%s'\n", addr[3].c_str(), rawPref.c_str()); if (checkPrivKey(addr[3], key, -(i + 3), 2, compressed)) { nbFoundKey++; updateFound(); } }
+  secp->GetHash160(searchType, COMPRESSED, pte2[0], pte2[1], pte2[2], pte2[3], h0, h1, h2, h3);
+  checkHash160SSE<KIND>(h0, h1, h2, h3, i, -1, key, 2, COMPRESSED);
+
+}
+
+// ----------------------------------------------------------------------------
+
+template<int KIND, int MODE, bool SSE>
+void VanitySearch::checkGroup(Int &key, Point *pts, int grpSize) {
+
+  // KIND, MODE and SSE are constants, the dead branches are removed and the
+  // check calls inlined in each instance
+  if (KIND == CPU_CHECK_ZERO) {
+
+    for (int i = 0; i < grpSize && !endOfSearch; i++)
+      checkZeroBits(key, i, pts[i]);
+
+  } else if (KIND == CPU_CHECK_HEX) {
+
+    // No encoding, X and its endomorphism images are masked directly
+    for (int i = 0; i < grpSize && !endOfSearch; i++)
+      checkHex(key, i, pts[i]);
+
+  } else if (KIND == CPU_CHECK_XTARGET) {
+
+    for (int i = 0; i < grpSize && !endOfSearch; i++)
+      checkXTarget(key, i, pts[i]);
+
+  } else if (KIND == CPU_CHECK_NPUB && SSE) {
+
+    // 4 npub encoded at once, matched as in checkNpub()
+    for (int i = 0; i < grpSize && !endOfSearch; i += 4) {
+      char addr[4][NPUB_MAX_LENGTH];
+      secp->GetNostrNpub(pts[i], pts[i + 1], pts[i + 2], pts[i + 3], addr);
+      for (int j = 0; j < 4; j++)
+        checkNpub(key, i + j, addr[j]);
+    }
+
+  } else if (KIND == CPU_CHECK_NPUB) {
+
+    for (int i = 0; i < grpSize && !endOfSearch; i++)
+      checkNpub(key, i, pts[i]);
+
+  } else if (SSE) {
+
+    // Addresses, by prefix table, target file or pattern
+    for (int i = 0; i < grpSize && !endOfSearch; i += 4) {
+      if (MODE != SEARCH_UNCOMPRESSED)
+        checkAddressesSSE<KIND, true>(key, i, pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
+      if (MODE != SEARCH_COMPRESSED)
+        checkAddressesSSE<KIND, false>(key, i, pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
+    }
+
+  } else {
+
+    for (int i = 0; i < grpSize && !endOfSearch; i++) {
+      if (MODE != SEARCH_UNCOMPRESSED)
+        checkAddresses<KIND, true>(key, i, pts[i]);
+      if (MODE != SEARCH_COMPRESSED)
+        checkAddresses<KIND, false>(key, i, pts[i]);
+    }
+
+  }
+
+}
+
+#define CHECK_GROUP_MODES(kind,sse)                                   \
+  (searchMode == SEARCH_COMPRESSED) ? &VanitySearch::checkGroup<kind, SEARCH_COMPRESSED, sse> :     \
+  (searchMode == SEARCH_UNCOMPRESSED) ? &VanitySearch::checkGroup<kind, SEARCH_UNCOMPRESSED, sse> : \
+  &VanitySearch::checkGroup<kind, SEARCH_BOTH, sse>
+
+#define CHECK_GROUP_ADDRESSES(kind) \
+  useSSE ? (CHECK_GROUP_MODES(kind, true)) : (CHECK_GROUP_MODES(kind, false))
+
+void VanitySearch::selectCheckGroup() {
+
+  // One instance per search, chosen once before the CPU threads start
+  if (zeroBits > 0) {
+    checkGroupFunc = &VanitySearch::checkGroup<CPU_CHECK_ZERO, SEARCH_COMPRESSED, false>;
+    keyPerPoint = 3;
+  } else if (searchType == NOSTR_HEX) {
+    checkGroupFunc = &VanitySearch::checkGroup<CPU_CHECK_HEX, SEARCH_COMPRESSED, false>;
+    keyPerPoint = 3;
+  } else if (xTargets) {
+    checkGroupFunc = &VanitySearch::checkGroup<CPU_CHECK_XTARGET, SEARCH_COMPRESSED, false>;
+    keyPerPoint = 1;
+  } else if (searchType == NOSTR_NPUB) {
+    // Patterns are matched without the leading "npub1"
+    npubSuffixes.clear();
+    for (int i = 0; i < (int)inputPrefixes.size(); i++) {
+      const char *p = inputPrefixes[i].c_str();
+      if (inputPrefixes[i].rfind("npub", 0) == 0) {
+        p += 4;
+        if (*p == '1') p++;
+      }
+      npubSuffixes.push_back(string(p));
     }
+    if (useSSE)
+      checkGroupFunc = &VanitySearch::checkGroup<CPU_CHECK_NPUB, SEARCH_COMPRESSED, true>;
+    else
+      checkGroupFunc = &VanitySearch::checkGroup<CPU_CHECK_NPUB, SEARCH_COMPRESSED, false>;
+    keyPerPoint = 1;
   } else {
-    secp->GetHash160(searchType, compressed, pte2[0], pte2[1], pte2[2], pte2[3], h0, h1, h2, h3);
-    if (!hasPattern) {
-      pr0 = *(prefix_t *)h0; pr1 = *(prefix_t *)h1; pr2 = *(prefix_t *)h2; pr3 = *(prefix_t *)h3;
-      if (prefixes[pr0].items) checkAddr(pr0, h0, key, -i, 2, compressed);
-      if (prefixes[pr1].items) checkAddr(pr1, h1, key, -(i + 1), 2, compressed);
-      if (prefixes[pr2].items) checkAddr(pr2, h2, key, -(i + 2), 2, compressed);
-      if (prefixes[pr3].items) checkAddr(pr3, h3, key, -(i + 3), 2, compressed);
+    // Addresses, the instance fixes the address check so no search option
+    // is tested per key, the GPU hits go through the same address check
+    if (hasPattern && searchType == BECH32) {
+      checkGroupFunc = CHECK_GROUP_ADDRESSES(CPU_CHECK_BECH32);
+      checkAddrFunc = &VanitySearch::checkAddr<CPU_CHECK_BECH32>;
+    } else if (hasPattern) {
+      checkGroupFunc = CHECK_GROUP_ADDRESSES(CPU_CHECK_PATTERN);
+      checkAddrFunc = &VanitySearch::checkAddr<CPU_CHECK_PATTERN>;
+    } else if (targetFile) {
+      checkGroupFunc = CHECK_GROUP_ADDRESSES(CPU_CHECK_TARGET);
+      checkAddrFunc = &VanitySearch::checkAddr<CPU_CHECK_TARGET>;
+    } else if (onlyFull) {
+      checkGroupFunc = CHECK_GROUP_ADDRESSES(CPU_CHECK_FULL);
+      checkAddrFunc = &VanitySearch::checkAddr<CPU_CHECK_FULL>;
     } else {
-      checkAddrSSE(h0, h1, h2, h3, -i, -(i + 1), -(i + 2), -(i + 3), key, 2, compressed);
+      checkGroupFunc = CHECK_GROUP_ADDRESSES(CPU_CHECK_PREFIX);
+      checkAddrFunc = &VanitySearch::checkAddr<CPU_CHECK_PREFIX>;
     }
+    base58Version = (searchType == P2SH) ? 0x05 : 0x00;
+    keyPerPoint = 6;
   }
 
 }
 
 // ----------------------------------------------------------------------------
-void VanitySearch::getCPUStartingKey(int thId,Int& key,Point& startP) {
+NODE_TABLE *VanitySearch::getNodeTable(int node) {
+
+#ifdef WIN64
+  WaitForSingleObject(nodeMutex, INFINITE);
+#else
+  pthread_mutex_lock(&nodeMutex);
+#endif
+
+  if (node >= (int)nodeTables.size())
+    nodeTables.resize(node + 1, NULL);
+
+  if (nodeTables[node] == NULL) {
+    // Written by the calling thread, first touch on its node
+    NODE_TABLE *t = new NODE_TABLE;
+    t->secp = new Secp256K1(*secp);
+    for (int i = 0; i < cpuGrpSize / 2; i++)
+      t->Gn[i] = Gn[i];
+    t->_2Gn = _2Gn;
+    nodeTables[node] = t;
+  }
+  NODE_TABLE *t = nodeTables[node];
+
+#ifdef WIN64
+  ReleaseMutex(nodeMutex);
+#else
+  pthread_mutex_unlock(&nodeMutex);
+#endif
+
+  return t;
+
+}
+
+void VanitySearch::getCPUStartingKey(uint64_t chunk,Int& key,Point& startP,Secp256K1 *secp) {
 
   if (rekey > 0) {
     key.Rand(256);
   } else {
+    // First key of the chunk
     key.Set(&startKey);
-    Int off((int64_t)thId);
-    off.ShiftL(64);
+    Int off(chunk);
+    off.Mult((uint64_t)KEY_CHUNK_SIZE);
     key.Add(&off);
   }
   Int km(&key);
-  km.Add((uint64_t)CPU_GRP_SIZE / 2);
+  km.Add((uint64_t)(cpuGrpSize / 2));
   startP = secp->ComputePublicKey(&km);
   if(startPubKeySpecified)
    startP = secp->AddDirect(startP,startPubKey);
 
 }
 
-void VanitySearch::FindKeyCPU(TH_PARAM *ph) {
+// ----------------------------------------------------------------------------
 
-  // Global init
-  int thId = ph->threadId;
-  counters[thId] = 0;
-  const bool doProfile = (getenv("VS_PROFILE") != NULL);
-  const bool showProgress = (getenv("VS_PROGRESS") != NULL);
-  double prof_loop_start, prof_fill_end, prof_inv_end, prof_check_end;
+void VanitySearch::getFoundFlags(vector<uint8_t> &flags) {
+
+  // Same order on every run with the same input
+  flags.clear();
+  if (patternFound)
+    for (int i = 0; i < (int)inputPrefixes.size(); i++)
+      flags.push_back(patternFound[i] ? 1 : 0);
+  if (targetFile)
+    flags.insert(flags.end(), targetFile->found, targetFile->found + targetFile->nbHash);
+  if (xTargets)
+    flags.insert(flags.end(), xTargets->found, xTargets->found + xTargets->nbTarget);
+  for (int i = 0; i < (int)usedPrefix.size(); i++) {
+    vector<PREFIX_ITEM> *items = prefixes[usedPrefix[i]].items;
+    for (int j = 0; items && j < (int)items->size(); j++)
+      flags.push_back(*((*items)[j].found) ? 1 : 0);
+  }
 
-  // CPU Thread
-  IntGroup *grp = new IntGroup(CPU_GRP_SIZE/2+1);
+}
 
-  // Group Init
-  Int  key;
-  Point startP;
-  getCPUStartingKey(thId,key,startP);
+void VanitySearch::setFoundFlags(vector<uint8_t> &flags) {
+
+  size_t n = 0;
+  if (patternFound)
+    for (int i = 0; i < (int)inputPrefixes.size(); i++)
+      patternFound[i] = flags[n++] != 0;
+  if (targetFile) {
+    targetFile->nbFound = 0;
+    for (uint64_t i = 0; i < targetFile->nbHash; i++)
+      targetFile->nbFound += (targetFile->found[i] = flags[n++]) ? 1 : 0;
+  }
+  if (xTargets) {
+    xTargets->nbFound = 0;
+    for (uint64_t i = 0; i < xTargets->nbTarget; i++)
+      xTargets->nbFound += (xTargets->found[i] = flags[n++]) ? 1 : 0;
+  }
+  for (int i = 0; i < (int)usedPrefix.size(); i++) {
+    vector<PREFIX_ITEM> *items = prefixes[usedPrefix[i]].items;
+    for (int j = 0; items && j < (int)items->size(); j++)
+      *((*items)[j].found) = flags[n++] != 0;
+  }
+
+}
 
-  Int dx[CPU_GRP_SIZE/2+1];
-  Point pts[CPU_GRP_SIZE];
+void VanitySearch::saveCheckpoint() {
+
+  // Hits of the walked chunks are queued before the chunk is done, they are
+  // verified and written before the checkpoint
+  vector<KEY_RANGE> ranges = sched.GetCheckpoint();
+#ifdef WIN64
+  WaitForSingleObject(hitMutex, INFINITE);
+  uint64_t nbHit = nbHitQueued;
+  ReleaseMutex(hitMutex);
+#else
+  pthread_mutex_lock(&hitMutex);
+  uint64_t nbHit = nbHitQueued;
+  pthread_mutex_unlock(&hitMutex);
+#endif
+  while (verifierRunning && nbHitDone < nbHit)
+    Timer::SleepMillis(1);
+  writer->Flush();
+
+  CHECKPOINT_HEADER h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.key, checkpointKey, 32);
+  for (int i = 0; i < 4; i++) {
+    h.baseKey[i] = startKey.bits64[i];
+    h.keyEnd[i] = keyEnd.bits64[i];
+  }
+  h.nbChunk = nbKeyChunk;
+  h.nbKey = resumedKeys + getCPUCount() + getGPUCount();
+  h.nbFound = nbFoundKey;
+  h.zeroBest = (zeroBits > 0) ? zeroBest : 0;
+  h.bounded = keyBounded ? 1 : 0;
+
+  vector<uint8_t> flags;
+  getFoundFlags(flags);
+  Checkpoint::Save(checkpointFile, h, ranges, flags);
+
+}
+
+// ----------------------------------------------------------------------------
+
+// Walk of a group: pts[i] = startP + (i - GRP_SIZE/2).G with one ModInv for
+// the group, startP is moved to the next center (startP + GRP_SIZE.G).
+// Gn[i] = (i+1).G, _2Gn = GRP_SIZE.G
+template<int GRP_SIZE>
+static void walkGroup(Point *Gn, Point &_2Gn, IntGroup *grp, Int *dx, Point &startP, Point *pts) {
 
   Int dy;
   Int dyn;
@@ -1546,132 +2216,253 @@ void VanitySearch::FindKeyCPU(TH_PARAM *ph) {
   Int _p;
   Point pp;
   Point pn;
-  grp->Set(dx);
+  int i;
+  int hLength = (GRP_SIZE / 2 - 1);
 
-  ph->hasStarted = true;
-  ph->rekeyRequest = false;
+  for (i = 0; i < hLength; i++) {
+    dx[i].ModSub(&Gn[i].x, &startP.x);
+  }
+  dx[i].ModSub(&Gn[i].x, &startP.x);  // For the first point
+  dx[i+1].ModSub(&_2Gn.x, &startP.x); // For the next center point
 
-  while (!endOfSearch) {
-    prof_loop_start = Timer::get_tick();
+  // Grouped ModInv
+  grp->ModInv();
 
-    if (ph->rekeyRequest) {
-      getCPUStartingKey(thId, key, startP);
-      ph->rekeyRequest = false;
-    }
+  // We use the fact that P + i*G and P - i*G has the same deltax, so the same inverse
+  // We compute key in the positive and negative way from the center of the group
 
-    int i;
-    int hLength = (CPU_GRP_SIZE / 2 - 1);
+  // center point
+  pts[GRP_SIZE/2] = startP;
 
-    if (searchType == NOSTR_NPUB) {
-      // OPTIMIZED: Back to proven fast NextKey but with reduced CPU_GRP_SIZE if needed
-      Point p0 = secp->ComputePublicKey(&key);
-      if (startPubKeySpecified)
-        p0 = secp->AddDirect(p0, startPubKey);
-      pts[0] = p0;
-      for (i = 1; i < CPU_GRP_SIZE && !endOfSearch; i++) {
-        pts[i] = secp->NextKey(pts[i - 1]);
-      }
-      prof_inv_end = Timer::get_tick();
-    } else {
-      // 既存: バッチ逆元を用いた群生成
-      for (i = 0; i < hLength; i++) {
-        dx[i].ModSub(&Gn[i].x, &startP.x);
-      }
-      dx[i].ModSub(&Gn[i].x, &startP.x);  // For the first point
-      dx[i+1].ModSub(&_2Gn.x, &startP.x); // For the next center point
+  for (i = 0; i<hLength; i++) {
 
-      // Grouped ModInv
-      grp->ModInv();
-      prof_inv_end = Timer::get_tick();
+    pp = startP;
+    pn = startP;
 
-      // We use the fact that P + i*G and P - i*G has the same deltax, so the same inverse
-      // We compute key in the positive and negative way from the center of the group
+    // P = startP + i*G
+    dy.ModSub(&Gn[i].y,&pp.y);
 
-      // center point
-      pts[CPU_GRP_SIZE/2] = startP;
+    _s.ModMulK1(&dy, &dx[i]);       // s = (p2.y-p1.y)*inverse(p2.x-p1.x);
+    _p.ModSquareK1(&_s);            // _p = pow2(s)
 
-      for (i = 0; i<hLength && !endOfSearch; i++) {
+    pp.x.ModNeg();
+    pp.x.ModAdd(&_p);
+    pp.x.ModSub(&Gn[i].x);           // rx = pow2(s) - p1.x - p2.x;
 
-        pp = startP;
-        pn = startP;
+    pp.y.ModSub(&Gn[i].x, &pp.x);
+    pp.y.ModMulK1(&_s);
+    pp.y.ModSub(&Gn[i].y);           // ry = - p2.y - s*(ret.x-p2.x);
 
-        // P = startP + i*G
-        dy.ModSub(&Gn[i].y,&pp.y);
+    // P = startP - i*G  , if (x,y) = i*G then (x,-y) = -i*G
+    dyn.Set(&Gn[i].y);
+    dyn.ModNeg();
+    dyn.ModSub(&pn.y);
 
-        _s.ModMulK1(&dy, &dx[i]);       // s = (p2.y-p1.y)*inverse(p2.x-p1.x);
-        _p.ModSquareK1(&_s);            // _p = pow2(s)
+    _s.ModMulK1(&dyn, &dx[i]);      // s = (p2.y-p1.y)*inverse(p2.x-p1.x);
+    _p.ModSquareK1(&_s);            // _p = pow2(s)
 
-        pp.x.ModNeg();
-        pp.x.ModAdd(&_p);
-        pp.x.ModSub(&Gn[i].x);           // rx = pow2(s) - p1.x - p2.x;
+    pn.x.ModNeg();
+    pn.x.ModAdd(&_p);
+    pn.x.ModSub(&Gn[i].x);          // rx = pow2(s) - p1.x - p2.x;
 
-        pp.y.ModSub(&Gn[i].x, &pp.x);
-        pp.y.ModMulK1(&_s);
-        pp.y.ModSub(&Gn[i].y);           // ry = - p2.y - s*(ret.x-p2.x);
+    pn.y.ModSub(&Gn[i].x, &pn.x);
+    pn.y.ModMulK1(&_s);
+    pn.y.ModAdd(&Gn[i].y);          // ry = - p2.y - s*(ret.x-p2.x);
 
-        // P = startP - i*G  , if (x,y) = i*G then (x,-y) = -i*G
-        dyn.Set(&Gn[i].y);
-        dyn.ModNeg();
-        dyn.ModSub(&pn.y);
+    pts[GRP_SIZE/2 + (i+1)] = pp;
+    pts[GRP_SIZE/2 - (i+1)] = pn;
 
-        _s.ModMulK1(&dyn, &dx[i]);      // s = (p2.y-p1.y)*inverse(p2.x-p1.x);
-        _p.ModSquareK1(&_s);            // _p = pow2(s)
+  }
 
-        pn.x.ModNeg();
-        pn.x.ModAdd(&_p);
-        pn.x.ModSub(&Gn[i].x);          // rx = pow2(s) - p1.x - p2.x;
+  // First point (startP - (GRP_SZIE/2)*G)
+  pn = startP;
+  dyn.Set(&Gn[i].y);
+  dyn.ModNeg();
+  dyn.ModSub(&pn.y);
 
-        pn.y.ModSub(&Gn[i].x, &pn.x);
-        pn.y.ModMulK1(&_s);
-        pn.y.ModAdd(&Gn[i].y);          // ry = - p2.y - s*(ret.x-p2.x);
+  _s.ModMulK1(&dyn, &dx[i]);
+  _p.ModSquareK1(&_s);
 
-        pts[CPU_GRP_SIZE/2 + (i+1)] = pp;
-        pts[CPU_GRP_SIZE/2 - (i+1)] = pn;
+  pn.x.ModNeg();
+  pn.x.ModAdd(&_p);
+  pn.x.ModSub(&Gn[i].x);
 
-      }
+  pn.y.ModSub(&Gn[i].x, &pn.x);
+  pn.y.ModMulK1(&_s);
+  pn.y.ModAdd(&Gn[i].y);
+
+  pts[0] = pn;
+
+  // Next start point (startP + GRP_SIZE*G)
+  pp = startP;
+  dy.ModSub(&_2Gn.y, &pp.y);
+
+  _s.ModMulK1(&dy, &dx[i+1]);
+  _p.ModSquareK1(&_s);
+
+  pp.x.ModNeg();
+  pp.x.ModAdd(&_p);
+  pp.x.ModSub(&_2Gn.x);
+
+  pp.y.ModSub(&_2Gn.x, &pp.x);
+  pp.y.ModMulK1(&_s);
+  pp.y.ModSub(&_2Gn.y);
+  startP = pp;
+
+}
+
+// ----------------------------------------------------------------------------
+
+template<int GRP_SIZE>
+double VanitySearch::benchGroup(double duration) {
+
+  // Walk and check of the search, the check reads the whole group after
+  // the walk so its cost depends on the group size too
+  IntGroup grp(GRP_SIZE/2+1);
+  Int *dx = new Int[GRP_SIZE/2+1];
+  Point *pts = new Point[GRP_SIZE];
+  grp.Set(dx);
+  Point _2GnS = secp->DoubleDirect(::Gn[GRP_SIZE/2-1]);
+  Int key;
+  key.Rand(256);
+  Point startP = secp->ComputePublicKey(&key);
+
+  uint64_t nbKey = 0;
+  double t0 = Timer::get_tick();
+  double t1;
+  do {
+    walkGroup<GRP_SIZE>(::Gn, _2GnS, &grp, dx, startP, pts);
+    (this->*checkGroupFunc)(key, pts, GRP_SIZE);
+    key.Add((uint64_t)GRP_SIZE);
+    nbKey += GRP_SIZE;
+    t1 = Timer::get_tick();
+  } while (t1 - t0 < duration);
+
+  delete[] dx;
+  delete[] pts;
+  return (double)nbKey / (t1 - t0);
 
-      // First point (startP - (GRP_SZIE/2)*G)
-      pn = startP;
-      dyn.Set(&Gn[i].y);
-      dyn.ModNeg();
-      dyn.ModSub(&pn.y);
+}
+
+static const int cpuGrpSizes[NB_CPU_GRP_SIZE] = { 128, 256, 288, 512, 1024, 2048, 4096 };
+
+void VanitySearch::selectGroupSize() {
+
+  if (cpuGrpSize == 0) {
+
+    // Fastest search on this host, sizes are measured twice (interleaved)
+    // and the best rate of each is kept. The -lz best is restored after.
+    double (VanitySearch::*bench[NB_CPU_GRP_SIZE])(double) = {
+      &VanitySearch::benchGroup<128>, &VanitySearch::benchGroup<256>,
+      &VanitySearch::benchGroup<288>, &VanitySearch::benchGroup<512>,
+      &VanitySearch::benchGroup<1024>, &VanitySearch::benchGroup<2048>,
+      &VanitySearch::benchGroup<4096>
+    };
+    double rate[NB_CPU_GRP_SIZE];
+    for (int i = 0; i < NB_CPU_GRP_SIZE; i++)
+      rate[i] = 0.0;
+    int best0 = zeroBest;
+    uint64_t limit0 = zeroLimit;
+    calibrating = true;
+    for (int pass = 0; pass < 2; pass++)
+      for (int i = 0; i < NB_CPU_GRP_SIZE; i++)
+        rate[i] = max(rate[i], (this->*bench[i])(CPU_CALIBRATION_TIME));
+    calibrating = false;
+    zeroBest = best0;
+    zeroLimit = limit0;
+
+    int best = 0;
+    for (int i = 1; i < NB_CPU_GRP_SIZE; i++)
+      if (rate[i] > rate[best])
+        best = i;
+    cpuGrpSize = cpuGrpSizes[best];
+    printf("CPU group size: %d (calibrated, %.3f Mkey/s per thread)\n", cpuGrpSize, rate[best] / 1000000.0);
 
-      _s.ModMulK1(&dyn, &dx[i]);
-      _p.ModSquareK1(&_s);
+  } else {
 
-      pn.x.ModNeg();
-      pn.x.ModAdd(&_p);
-      pn.x.ModSub(&Gn[i].x);
+    printf("CPU group size: %d\n", cpuGrpSize);
 
-      pn.y.ModSub(&Gn[i].x, &pn.x);
-      pn.y.ModMulK1(&_s);
-      pn.y.ModAdd(&Gn[i].y);
+  }
+
+  _2Gn = secp->DoubleDirect(Gn[cpuGrpSize/2-1]);
+
+}
+
+// ----------------------------------------------------------------------------
+
+void VanitySearch::FindKeyCPU(TH_PARAM *ph) {
+
+  switch (cpuGrpSize) {
+  case 128:  findKeyCPU<128>(ph);  break;
+  case 256:  findKeyCPU<256>(ph);  break;
+  case 512:  findKeyCPU<512>(ph);  break;
+  case 1024: findKeyCPU<1024>(ph); break;
+  case 2048: findKeyCPU<2048>(ph); break;
+  case 4096: findKeyCPU<4096>(ph); break;
+  default:   findKeyCPU<CPU_GRP_SIZE>(ph); break;
+  }
 
-      pts[0] = pn;
+}
+
+template<int GRP_SIZE>
+void VanitySearch::findKeyCPU(TH_PARAM *ph) {
+
+  // Global init
+  int thId = ph->threadId;
+  THREAD_STAT *st = ph->stat;
+  threadStat = st;
+  const bool doProfile = (getenv("VS_PROFILE") != NULL);
+  double prof_loop_start, prof_inv_end, prof_check_end;
+
+  // Generator tables of the node the thread is pinned on (shared ones otherwise)
+  NODE_TABLE *nt = (ph->node >= 0) ? getNodeTable(ph->node) : NULL;
+  Point *Gn = nt ? nt->Gn : ::Gn;
+  Point &_2Gn = nt ? nt->_2Gn : ::_2Gn;
+  Secp256K1 *secp = nt ? nt->secp : this->secp;
+
+  // CPU Thread
+  IntGroup *grp = new IntGroup(GRP_SIZE/2+1);
+
+  // Key range from the scheduler (the rekey mode walks random keys)
+  bool scheduled = (rekey == 0);
+  uint64_t chunk = 0;
+  uint64_t rangeStart = 0;
+  uint64_t rangeEnd = 0;
+  int chunkGroup = 0;
+  bool walking = !scheduled || sched.Get(thId, rangeStart, rangeEnd);
+  chunk = rangeStart;
+
+  // Group Init
+  Int  key;
+  Point startP;
+  getCPUStartingKey(chunk,key,startP,secp);
 
-      // Next start point (startP + GRP_SIZE*G)
-      pp = startP;
-      dy.ModSub(&_2Gn.y, &pp.y);
+  // On the heap, a 4096 keys group does not fit a small thread stack
+  Int *dx = new Int[GRP_SIZE/2+1];
+  Point *pts = new Point[GRP_SIZE];
+  grp->Set(dx);
 
-      _s.ModMulK1(&dy, &dx[i+1]);
-      _p.ModSquareK1(&_s);
+  ph->hasStarted = true;
+  ph->rekeyRequest = false;
 
-      pp.x.ModNeg();
-      pp.x.ModAdd(&_p);
-      pp.x.ModSub(&_2Gn.x);
+  while (walking && !endOfSearch) {
+    prof_loop_start = Timer::get_tick();
 
-      pp.y.ModSub(&_2Gn.x, &pp.x);
-      pp.y.ModMulK1(&_s);
-      pp.y.ModSub(&_2Gn.y);
-      startP = pp;
+    if (ph->rekeyRequest) {
+      getCPUStartingKey(0, key, startP, secp);
+      ph->rekeyRequest = false;
     }
 
+    // Group walk
+    walkGroup<GRP_SIZE>(Gn, _2Gn, grp, dx, startP, pts);
+    prof_inv_end = Timer::get_tick();
+
 #if 0
     // Check
     {
       bool wrong = false;
       Point p0 = secp.ComputePublicKey(&key);
-      for (int i = 0; i < CPU_GRP_SIZE; i++) {
+      for (int i = 0; i < GRP_SIZE; i++) {
         if (!p0.equals(pts[i])) {
           wrong = true;
           printf("[%d] wrong point\n",i);
@@ -1683,121 +2474,71 @@ void VanitySearch::FindKeyCPU(TH_PARAM *ph) {
 #endif
 
     // Check addresses
-    if (useSSE) {
-
-      if (searchType == NOSTR_NPUB) {
-        // ZERO-ALLOC: 固定配列でメモリ確保排除
-        static thread_local NostrOptimized::PatternData preprocessedPatterns[32]; // 最大32パターン
-        static thread_local int patternCount = -1;
-        
-        if (patternCount == -1) {
-          patternCount = 0;
-          for (int idx = 0; idx < (int)inputPrefixes.size() && patternCount < 32; idx++) {
-            NostrOptimized::PatternData pattern = NostrOptimized::preprocessPattern(inputPrefixes[idx]);
-            if (pattern.isValid) {
-              preprocessedPatterns[patternCount++] = pattern;
-            }
-          }
-        }
-        
-        for (int i = 0; i < CPU_GRP_SIZE && !endOfSearch; i += 4) {
-          bool matches[4];
-          NostrOptimized::batchMatch(pts[i], pts[i + 1], pts[i + 2], pts[i + 3], 
-                                   preprocessedPatterns, patternCount, matches);
-          
-          // ZERO-ALLOC: 事前計算されたキーと直接出力
-          static thread_local char addr_buffer[128];
-          static thread_local Int k_precomputed[4];
-          
-          for (int j = 0; j < 4 && (i + j) < CPU_GRP_SIZE; j++) {
-            if (matches[j]) {
-              // Generate full npub only when we have a match
-              NostrOptimized::generateNpubDirect(pts[i + j], addr_buffer);
-              
-              // 事前計算: キー構築の最適化
-              k_precomputed[j] = key;
-              k_precomputed[j].Add((uint64_t)(i + j));
-              
-              // 直接const char*として出力（stringコピー排除）
-              output(string(addr_buffer), secp->GetPrivAddress(true, k_precomputed[j]), k_precomputed[j].GetBase16());
-              nbFoundKey++; updateFound();
-            }
-          }
-        }
-      } else {
-        // Standard batch processing for other search types
-        for (int i = 0; i < CPU_GRP_SIZE && !endOfSearch; i += 4) {
-          switch (searchMode) {
-            case SEARCH_COMPRESSED:
-              checkAddressesSSE(true, key, i, pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
-              break;
-            case SEARCH_UNCOMPRESSED:
-              checkAddressesSSE(false, key, i, pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
-              break;
-            case SEARCH_BOTH:
-              checkAddressesSSE(true, key, i, pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
-              checkAddressesSSE(false, key, i, pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
-              break;
-          }
-        }
-      }
-
-    } else {
-
-      for (int i = 0; i < CPU_GRP_SIZE && !endOfSearch; i ++) {
-
-        switch (searchMode) {
-        case SEARCH_COMPRESSED:
-          checkAddresses(true, key, i, pts[i]);
-          break;
-        case SEARCH_UNCOMPRESSED:
-          checkAddresses(false, key, i, pts[i]);
-          break;
-        case SEARCH_BOTH:
-          checkAddresses(true, key, i, pts[i]);
-          checkAddresses(false, key, i, pts[i]);
-          break;
-        }
-
-      }
+    (this->*checkGroupFunc)(key, pts, GRP_SIZE);
 
-    }
-
-    key.Add((uint64_t)CPU_GRP_SIZE);
-    int mult = (searchType == NOSTR_NPUB) ? 1 : 6;
-    counters[thId]+= mult*CPU_GRP_SIZE; // Nostrは素の点のみ、BTCは6倍
+    key.Add((uint64_t)GRP_SIZE);
+    prof_check_end = Timer::get_tick();
+    st->keys += keyPerPoint*GRP_SIZE;
+    st->groups++;
+    st->walkTime += prof_inv_end - prof_loop_start;
+    st->checkTime += prof_check_end - prof_inv_end;
 
     if (doProfile) {
-      prof_check_end = Timer::get_tick();
-      vs_debug_logf("[CPU th:%d] fill+inv=%.1f ms, check=%.1f ms, grp=%d, counter+=%d\n",
+      vs_debug_logf("[CPU th:%d] walk=%.1f ms, check=%.1f ms, grp=%d, counter+=%d\n",
                     thId,
                     (prof_inv_end - prof_loop_start) * 1000.0,
                     (prof_check_end - prof_inv_end) * 1000.0,
-                    CPU_GRP_SIZE,
-                     mult*CPU_GRP_SIZE);
+                    GRP_SIZE,
+                    keyPerPoint*GRP_SIZE);
+    }
+
+    // End of chunk, take an other range when this one is done or stolen
+    if (scheduled && ++chunkGroup == KEY_CHUNK_SIZE / GRP_SIZE) {
+      chunkGroup = 0;
+      if (!sched.Next(thId, chunk)) {
+        sched.Done(rangeStart, chunk);
+        walking = sched.Get(thId, rangeStart, rangeEnd);
+        chunk = rangeStart;
+        if (walking)
+          getCPUStartingKey(chunk, key, startP, secp);
+      }
     }
 
   }
 
+  // Chunks fully walked before the end of the search
+  if (scheduled && walking)
+    sched.Done(rangeStart, chunk);
+
+  delete grp;
+  delete[] dx;
+  delete[] pts;
   ph->isRunning = false;
 
 }
 
 // ----------------------------------------------------------------------------
 
-void VanitySearch::getGPUStartingKeys(int thId, int groupSize, int nbThread, Int *keys, Point *p) {
+bool VanitySearch::getGPUStartingKeys(int groupSize, int nbThread, uint64_t *blocks, Int *keys, Point *p) {
+
+  // One block per thread, the surplus threads walk the first block again
+  // when the keyspace is nearly exhausted
+  if (rekey == 0) {
+    int nb = sched.GetBlocks(blocks, nbThread);
+    if (nb == 0)
+      return false;
+    for (int i = nb; i < nbThread; i++)
+      blocks[i] = blocks[0];
+  }
 
   for (int i = 0; i < nbThread; i++) {
     if (rekey > 0) {
       keys[i].Rand(256);
     } else {
       keys[i].Set(&startKey);
-      Int offT((uint64_t)i);
-      offT.ShiftL(80);
-      Int offG((uint64_t)thId);
-      offG.ShiftL(112);
-      keys[i].Add(&offT);
-      keys[i].Add(&offG);
+      Int off(blocks[i]);
+      off.Mult((uint64_t)KEY_CHUNK_SIZE);
+      keys[i].Add(&off);
     }
     Int k(keys + i);
     // Starting key is at the middle of the group
@@ -1807,6 +2548,8 @@ void VanitySearch::getGPUStartingKeys(int thId, int groupSize, int nbThread, Int
       p[i] = secp->AddDirect(p[i], startPubKey);
   }
 
+  return true;
+
 }
 
 void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
@@ -1821,17 +2564,22 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
   int nbThread = g.GetNbThread();
   Point *p = new Point[nbThread];
   Int *keys = new Int[nbThread];
+  uint64_t *blocks = new uint64_t[nbThread];
+  uint64_t nbLaunch = 0;
   vector<ITEM> found;
 
   printf("GPU: %s\n",g.deviceName.c_str());
 
-  counters[thId] = 0;
-
-  getGPUStartingKeys(thId, g.GetGroupSize(), nbThread, keys, p);
+  THREAD_STAT *st = ph->stat;
+  threadStat = st;
 
   g.SetSearchMode(searchMode);
   g.SetSearchType(searchType);
-  if (searchType == NOSTR_NPUB) {
+  if (zeroBits > 0) {
+    g.SetZeroBits(zeroFloor);
+  } else if (searchType == NOSTR_HEX) {
+    g.SetHexPattern((const uint64_t *)hexMasks.data(), (int)hexMasks.size());
+  } else if (searchType == NOSTR_NPUB) {
     // NostrはGPU側で文字列パターン照合を行うため、ワイルドカード有無に関わらずパターン文字列を渡す
     g.SetPattern(inputPrefixes[0].c_str());
     vs_debug_logf("[FindKeyGPU] SetPattern '%s' (gpuId=%d grid=%dx%d threads=%d)\n",
@@ -1840,15 +2588,17 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
     if (onlyFull) {
       g.SetPrefix(usedPrefixL, nbPrefix);
     } else {
-      if (hasPattern)
+      if (hasPattern && searchType != BECH32)
         g.SetPattern(inputPrefixes[0].c_str());
       else
         g.SetPrefix(usedPrefix);
     }
   }
 
-  getGPUStartingKeys(thId, g.GetGroupSize(), nbThread, keys, p);
-  ok = g.SetKeys(p);
+  int gpu = thId - 0x80;
+  ok = getGPUStartingKeys(g.GetGroupSize(), nbThread, blocks, keys, p) && g.SetKeys(p);
+  if (rekey == 0)
+    sched.SetBlocks(gpu, blocks, nbThread);
   ph->rekeyRequest = false;
 
   ph->hasStarted = true;
@@ -1857,22 +2607,33 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
   while (ok && !endOfSearch) {
 
     if (ph->rekeyRequest) {
-      getGPUStartingKeys(thId, g.GetGroupSize(), nbThread, keys, p);
-      ok = g.SetKeys(p);
+      ok = getGPUStartingKeys(g.GetGroupSize(), nbThread, blocks, keys, p) && g.SetKeys(p);
       ph->rekeyRequest = false;
     }
 
     // Call kernel
+    double t0 = Timer::get_tick();
     ok = g.Launch(found);
     if (!ok) {
       vs_debug_logf("[FindKeyGPU] Launch returned false.\n");
     }
+    double t1 = Timer::get_tick();
 
     for(int i=0;i<(int)found.size() && !endOfSearch;i++) {
 
       ITEM it = found[i];
 
-      if (searchType == NOSTR_NPUB) {
+      if (searchType == NOSTR_HEX) {
+        // Rebuild the candidate to find the pattern, checkPrivKey() confirms
+        Int k(&keys[it.thId]);
+        k.Add((uint64_t)it.incr);
+        Point p = secp->ComputePublicKey(&k);
+        if (startPubKeySpecified) p = secp->AddDirect(p, startPubKey);
+        if (zeroBits > 0)
+          checkZeroBits(keys[it.thId], it.incr, p);
+        else
+          checkHex(keys[it.thId], it.incr, p);
+      } else if (searchType == NOSTR_NPUB) {
         // Reconstruct public key for the found item and output npub
         Int baseKey = keys[it.thId];
         Int k(&baseKey);
@@ -1900,13 +2661,14 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
 
         Point p = secp->ComputePublicKey(&k);
         if (startPubKeySpecified) p = secp->AddDirect(p, sp);
-        string addr = secp->GetNostrNpub(p);
-        vs_debug_logf("[FindKeyGPU] candidate th=%u incr=%d endo=%d npub='%s'\n", it.thId, it.incr, it.endo, addr.c_str());
+        char addr[NPUB_MAX_LENGTH];
+        secp->GetNostrNpub(p, addr);
+        vs_debug_logf("[FindKeyGPU] candidate th=%u incr=%d endo=%d npub='%s'\n", it.thId, it.incr, it.endo, addr);
 
         // Host-side recheck: ensure npub actually matches requested prefix
         bool matched = false;
-        const char *full = addr.c_str();
-        const char *npubSuffix = (addr.rfind("npub1", 0) == 0) ? (full + 5) : full;
+        const char *full = addr;
+        const char *npubSuffix = (strncmp(addr, "npub1", 5) == 0) ? (full + 5) : full;
         for (int k = 0; k < (int)inputPrefixes.size() && !matched; k++) {
           const string &rawPref = inputPrefixes[k];
           const char *patt = rawPref.c_str();
@@ -1917,16 +2679,13 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
           }
         }
         if (!matched) {
-          vs_debug_logf("[FindKeyGPU] host-filter DROP npub='%s' (does not match requested prefix)\n", addr.c_str());
+          vs_debug_logf("[FindKeyGPU] host-filter DROP npub='%s' (does not match requested prefix)\n", addr);
           continue;
         }
 
-        if (checkPrivKey(addr, baseKey, it.incr, it.endo, it.mode)) {
-          nbFoundKey++;
-          updateFound();
-        }
+        checkPrivKey(addr, baseKey, it.incr, it.endo, it.mode);
       } else {
-        checkAddr(*(prefix_t *)(it.hash), it.hash, keys[it.thId], it.incr, it.endo, it.mode);
+        (this->*checkAddrFunc)(*(prefix_t *)(it.hash), it.hash, keys[it.thId], it.incr, it.endo, it.mode);
       }
 
     }
@@ -1935,11 +2694,29 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
       for (int i = 0; i < nbThread; i++) {
         keys[i].Add((uint64_t)STEP_SIZE);
       }
-      counters[thId] += 6ULL * STEP_SIZE * nbThread; // Point +  endo1 + endo2 + symetrics
+      if (searchType == NOSTR_HEX)
+        st->keys += 3ULL * STEP_SIZE * nbThread; // Point +  endo1 + endo2 (X only)
+      else
+        st->keys += 6ULL * STEP_SIZE * nbThread; // Point +  endo1 + endo2 + symetrics
+      st->groups++;
+    }
+    st->walkTime += t1 - t0;
+    st->checkTime += Timer::get_tick() - t1;
+
+    // End of the blocks, all threads move in lockstep
+    if (ok && rekey == 0 && ++nbLaunch == KEY_BLOCK_CHUNKS * KEY_CHUNK_SIZE / STEP_SIZE) {
+      nbLaunch = 0;
+      for (int i = 0; i < nbThread; i++)
+        sched.Done(blocks[i], blocks[i] + KEY_BLOCK_CHUNKS);
+      ok = getGPUStartingKeys(g.GetGroupSize(), nbThread, blocks, keys, p) && g.SetKeys(p);
+      sched.SetBlocks(gpu, blocks, nbThread);
+    } else if (ok && rekey == 0 && (nbLaunch * STEP_SIZE) % KEY_CHUNK_SIZE == 0) {
+      sched.SetWalked(gpu, nbLaunch * STEP_SIZE / KEY_CHUNK_SIZE);
     }
 
   }
 
+  delete[] blocks;
   delete[] keys;
   delete[] p;
 
@@ -1956,12 +2733,16 @@ void VanitySearch::FindKeyGPU(TH_PARAM *ph) {
 
 bool VanitySearch::isAlive(TH_PARAM *p) {
 
+  // A bounded keyspace is walked until the last thread stops
   bool isAlive = true;
+  bool isWalking = false;
   int total = nbCPUThread + nbGPUThread;
-  for(int i=0;i<total;i++)
+  for(int i=0;i<total;i++) {
     isAlive = isAlive && p[i].isRunning;
+    isWalking = isWalking || p[i].isRunning;
+  }
 
-  return isAlive;
+  return (nbKeyChunk != KEY_UNBOUNDED) ? isWalking : isAlive;
 
 }
 
@@ -1993,19 +2774,13 @@ void VanitySearch::rekeyRequest(TH_PARAM *p) {
 
 uint64_t VanitySearch::getGPUCount() {
 
-  uint64_t count = 0;
-  for(int i=0;i<nbGPUThread;i++)
-    count += counters[0x80L+i];
-  return count;
+  return registry.GetGPUCount();
 
 }
 
 uint64_t VanitySearch::getCPUCount() {
 
-  uint64_t count = 0;
-  for(int i=0;i<nbCPUThread;i++)
-    count += counters[i];
-  return count;
+  return registry.GetCPUCount();
 
 }
 
@@ -2027,33 +2802,77 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
   endOfSearch = false;
   nbCPUThread = nbThread;
   nbGPUThread = (useGpu?(int)gpuId.size():0);
-  nbFoundKey = 0;
-
-  memset(counters,0,sizeof(counters));
 
-  printf("Number of CPU thread: %d\n", nbCPUThread);
+  registry.Init(nbCPUThread, nbGPUThread);
+  sched.Init(nbKeyChunk, nbCPUThread, nbGPUThread);
+  if (resumed) {
+    sched.Restore(resumedRanges);
+    if (nbFoundKey > 0)
+      updateFound();
+  }
+  if (checkpointFile.length() > 0) {
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+  }
 
   TH_PARAM *params = (TH_PARAM *)malloc((nbCPUThread + nbGPUThread) * sizeof(TH_PARAM));
   memset(params,0,(nbCPUThread + nbGPUThread) * sizeof(TH_PARAM));
 
+  // CPU thread placement
+  vector<CPU_ITEM> layout;
+  if (pinMode != PIN_NONE) {
+    CpuTopology topo;
+    layout = topo.Layout(pinMode);
+    printf("Number of CPU thread: %d (pinned, %s layout, %d NUMA node%s)\n", nbCPUThread,
+      (pinMode == PIN_SMT) ? "smt" : "cores", topo.nbNode, (topo.nbNode > 1) ? "s" : "");
+  } else {
+    printf("Number of CPU thread: %d\n", nbCPUThread);
+  }
+#ifdef WIN64
+  nodeMutex = CreateMutex(NULL, FALSE, NULL);
+#else
+  pthread_mutex_init(&nodeMutex, NULL);
+#endif
+
   if (doProfile) {
     printf("[PROFILE] Search() start t=%.3fs\n", prof_t_search_start);
   }
 
-  // Launch CPU threads
+  // Result writer and hit verifier threads
+  writer->Start();
+  hits.clear();
+  nbHitQueued = 0;
+  nbHitDone = 0;
+  endOfHits = false;
+  verifierRunning = true;
+#ifdef WIN64
+  hitMutex = CreateMutex(NULL, FALSE, NULL);
+  DWORD verifier_id;
+  CreateThread(NULL, 0, _VerifyHits, (void*)this, 0, &verifier_id);
+#else
+  pthread_mutex_init(&hitMutex, NULL);
+  pthread_t verifier_id;
+  pthread_create(&verifier_id, NULL, &_VerifyHits, (void*)this);
+#endif
+
+  // Launch CPU threads, the group size is measured with the check instance
+  selectCheckGroup();
+  if (nbCPUThread > 0)
+    selectGroupSize();
   for (int i = 0; i < nbCPUThread; i++) {
     params[i].obj = this;
     params[i].threadId = i;
     params[i].isRunning = true;
+    params[i].cpu = layout.empty() ? -1 : layout[i % layout.size()].cpu;
+    params[i].node = layout.empty() ? -1 : layout[i % layout.size()].node;
+    params[i].stat = registry.GetCPU(i);
 
 #ifdef WIN64
     DWORD thread_id;
     CreateThread(NULL, 0, _FindKey, (void*)(params+i), 0, &thread_id);
-    ghMutex = CreateMutex(NULL, FALSE, NULL);
 #else
     pthread_t thread_id;
     pthread_create(&thread_id, NULL, &_FindKey, (void*)(params+i));
-    ghMutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
   }
 
@@ -2062,6 +2881,7 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
     params[nbCPUThread+i].obj = this;
     params[nbCPUThread+i].threadId = 0x80L+i;
     params[nbCPUThread+i].isRunning = true;
+    params[nbCPUThread+i].stat = registry.GetGPU(i);
     params[nbCPUThread+i].gpuId = gpuId[i];
     params[nbCPUThread+i].gridSizeX = gridSize[2*i];
     params[nbCPUThread+i].gridSizeY = gridSize[2*i+1];
@@ -2078,7 +2898,7 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
   setvbuf(stdout, NULL, _IONBF, 0);
 #endif
 
-  uint64_t lastCount = 0;
+  uint64_t lastCount = resumedKeys;
   uint64_t gpuCount = 0;
   uint64_t lastGPUCount = 0;
 
@@ -2111,18 +2931,24 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
 
   t0 = Timer::get_tick();
   startTime = t0;
+  double lastCheckpoint = t0;
 
   while (isAlive(params)) {
     double loop_start = Timer::get_tick();
 
     int delay = 2000;
-    while (isAlive(params) && delay>0) {
+    while (isAlive(params) && delay>0 && !interruptRequest) {
       Timer::SleepMillis(500);
       delay -= 500;
     }
 
+    if (interruptRequest) {
+      printf("\nInterrupted\n");
+      break;
+    }
+
     gpuCount = getGPUCount();
-    uint64_t count = getCPUCount() + gpuCount;
+    uint64_t count = getCPUCount() + gpuCount + resumedKeys;
 
     t1 = Timer::get_tick();
     keyRate = (double)(count - lastCount) / (t1 - t0);
@@ -2154,8 +2980,15 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
       char cpuBuf[32]; char gpuBuf[32];
       fmtRate(avgKeyRate, cpuBuf);
       fmtRate(avgGpuKeyRate, gpuBuf);
-      printf("\r[%s][GPU %s][Total 2^%.2f]%s[Found %d]  ",
-        cpuBuf, gpuBuf, log2((double)count), GetExpectedTime(avgKeyRate, (double)count).c_str(), nbFoundKey);
+      char bestBuf[32] = "";
+      if (zeroBits > 0)
+        sprintf(bestBuf, "[Best %d bits]", zeroBest);
+      char rangeBuf[32] = "";
+      if (nbKeyChunk != KEY_UNBOUNDED)
+        sprintf(rangeBuf, "[Keyspace %.2f%%]", 100.0 * (double)sched.GetNbCompleted() / (double)nbKeyChunk);
+      printf("\r[%s][GPU %s][Total 2^%.2f]%s%s%s[Found %d]  ",
+        cpuBuf, gpuBuf, log2((double)count), GetExpectedTime(avgKeyRate, (double)count).c_str(), bestBuf, rangeBuf,
+        nbFoundKey);
       if (showProgress) {
         printf(" [count=%llu]  ", (unsigned long long)count);
       }
@@ -2173,6 +3006,11 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
     lastGPUCount = gpuCount;
     t0 = t1;
 
+    if (checkpointFile.length() > 0 && t1 - lastCheckpoint >= CHECKPOINT_INTERVAL) {
+      saveCheckpoint();
+      lastCheckpoint = t1;
+    }
+
     if (doProfile) {
       double loop_end = Timer::get_tick();
       printf("\n[PROFILE] loop dt=%.1f ms count=%llu cpuRate=%.0f key/s\n",
@@ -2183,6 +3021,56 @@ void VanitySearch::Search(int nbThread,std::vector<int> gpuId,std::vector<int> g
 
   }
 
+  // Walked ranges and hits are recorded when the threads exit
+  endOfSearch = true;
+  for (int i = 0; i < nbCPUThread + nbGPUThread; i++)
+    while (params[i].isRunning)
+      Timer::SleepMillis(10);
+
+  // Queued hits are output before returning
+#ifdef WIN64
+  WaitForSingleObject(hitMutex, INFINITE);
+  endOfHits = true;
+  ReleaseMutex(hitMutex);
+#else
+  pthread_mutex_lock(&hitMutex);
+  endOfHits = true;
+  pthread_mutex_unlock(&hitMutex);
+#endif
+  while (verifierRunning)
+    Timer::SleepMillis(10);
+  writer->Stop();
+
+  if (checkpointFile.length() > 0) {
+    saveCheckpoint();
+    printf("\n[Checkpoint] Saved %s\n", checkpointFile.c_str());
+  }
+
+  if (rekey == 0) {
+    vector<KEY_RANGE> done = sched.GetCompleted();
+    double nbKey = (double)sched.GetNbCompleted() * (double)KEY_CHUNK_SIZE;
+    printf("\n[Coverage] 2^%.2f keys in %d range(s), %llu keys contiguous from the start key\n",
+      (nbKey > 0.0) ? log2(nbKey) : 0.0, (int)done.size(),
+      (unsigned long long)(sched.GetContiguous() * KEY_CHUNK_SIZE));
+    if (nbKeyChunk != KEY_UNBOUNDED && sched.GetContiguous() == nbKeyChunk)
+      printf("[Coverage] Keyspace exhausted\n");
+    if (doProfile) {
+      for (int i = 0; i < (int)done.size(); i++)
+        printf("[PROFILE] range %d: chunks [%llu,%llu)\n", i,
+               (unsigned long long)done[i].start, (unsigned long long)done[i].end);
+    }
+  }
+
+  if (doProfile) {
+    for (int i = 0; i < nbCPUThread + nbGPUThread; i++) {
+      THREAD_STAT *st = params[i].stat;
+      printf("[PROFILE] %s %d: keys=%llu groups=%llu hits=%llu walk=%.1f s check=%.1f s\n",
+             (i < nbCPUThread) ? "CPU" : "GPU", (i < nbCPUThread) ? i : i - nbCPUThread,
+             (unsigned long long)st->keys, (unsigned long long)st->groups, (unsigned long long)st->hits,
+             st->walkTime, st->checkTime);
+    }
+  }
+
   free(params);
 
 }
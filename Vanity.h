@@ -21,16 +21,46 @@
 #include <string>
 #include <vector>
 #include "SECP256k1.h"
+#include "Base58.h"
 #include "GPU/GPUEngine.h"
+#include "PrefixFile.h"
+#include "Hash160File.h"
+#include "NostrTargetSet.h"
+#include "Base58Range.h"
+#include "Bech32Pattern.h"
+#include "PatternAutomaton.h"
+#include "HexPattern.h"
+#include "ResultWriter.h"
+#include "CpuTopology.h"
+#include "ThreadRegistry.h"
+#include "KeyScheduler.h"
+#include "Checkpoint.h"
+#include "NostrOptimized.h"
 #ifdef WIN64
 #include <Windows.h>
 #endif
 
-// Further reduce group size to shorten per-iteration latency on Apple Silicon
-// レスポンスよりもスループット優先
-#define CPU_GRP_SIZE 288  // MICRO-TUNED: 288 = 32 * 9, perfect divisibility
+// CPU group sizes, the walk is instantiated for each of them and the fastest
+// one is calibrated at startup (-grp to force it). All divide KEY_CHUNK_SIZE
+// and are multiples of 4 (SSE checks).
+#define CPU_GRP_SIZE 288       // Former fixed size (Apple Silicon)
+#define CPU_GRP_SIZE_MAX 4096
+#define NB_CPU_GRP_SIZE 7      // 128,256,288,512,1024,2048,4096
+#define CPU_CALIBRATION_TIME 0.05 // Seconds per size and pass
 //#define STATIC_CPU_GTABLE  // Disabled until proper table generation
 
+// Checks of a CPU group, one instance of VanitySearch::checkGroup() per
+// check, search mode and SSE use
+#define CPU_CHECK_ZERO    0  // Leading zero bits of X (-lz)
+#define CPU_CHECK_HEX     1  // Hex masks on X
+#define CPU_CHECK_XTARGET 2  // Exact X targets
+#define CPU_CHECK_NPUB    3  // npub prefixes
+#define CPU_CHECK_PREFIX  4  // Address prefixes (prefix table)
+#define CPU_CHECK_PATTERN 5  // P2PKH and P2SH wildcard patterns
+#define CPU_CHECK_FULL    6  // Full addresses (prefix table and second level lookup)
+#define CPU_CHECK_TARGET  7  // Hash160 target file (-ih)
+#define CPU_CHECK_BECH32  8  // BECH32 wildcard patterns
+
 class VanitySearch;
 
 typedef struct {
@@ -43,9 +73,22 @@ typedef struct {
   int  gridSizeX;
   int  gridSizeY;
   int  gpuId;
+  int  cpu;   // Logical CPU the thread is pinned on, -1 if not pinned
+  int  node;  // NUMA node of the CPU
+  THREAD_STAT *stat;
 
 } TH_PARAM;
 
+// Read-only tables replicated on each NUMA node, a copy is made by the
+// first thread pinned on the node so its pages are local to it
+typedef struct {
+
+  Secp256K1 *secp;
+  Point Gn[CPU_GRP_SIZE_MAX / 2];
+  Point _2Gn;
+
+} NODE_TABLE;
+
 
 typedef struct {
 
@@ -60,39 +103,83 @@ typedef struct {
   prefixl_t lPrefix;
   uint8_t hash160[20];
 
+  // Base58 prefix as hash160 intervals (NULL when matched on the address string)
+  HASH160_RANGE *ranges;
+  int nbRange;
+
 } PREFIX_ITEM;
 
 typedef struct {
 
   std::vector<PREFIX_ITEM> *items;
   bool found;
+  prefixl_t *lPrefixes;  // 32 bits prefixes (Eytzinger order)
+  uint32_t nbLPrefix;
 
 } PREFIX_TABLE_ITEM;
 
+// Hit waiting for verification, the key is base key + incr and the
+// endomorphism, the opposite key is tried when the address differs. The
+// search threads wait for the verifier when HIT_QUEUE_SIZE hits are queued.
+#define HIT_BATCH_SIZE 256
+#define HIT_QUEUE_SIZE (64 * HIT_BATCH_SIZE)
+
+typedef struct {
+
+  Int key;
+  int32_t incr;
+  int32_t endomorphism;
+  bool mode;
+  char addr[ADDRESS_MAX_LENGTH];
+  bool *found;     // Prefix or pattern flag set once verified, NULL if none
+  int64_t target;  // Index in the -ih or -ix list, -1 if none
+  bool counted;    // Counted as a found key (-lz reports better keys below nbBit)
+
+} HIT_ITEM;
+
 class VanitySearch {
 
 public:
 
   VanitySearch(Secp256K1 *secp, std::vector<std::string> &prefix, std::string seed, int searchMode,
                bool useGpu,bool stop,std::string outputFile, bool useSSE,uint32_t maxFound,uint64_t rekey,
-               bool caseSensitive,Point &startPubKey,bool paranoiacSeed);
+               bool caseSensitive,Point &startPubKey,bool paranoiacSeed,PrefixFile *inputFile,
+               std::string snapshotFile,Hash160File *targetFile,NostrTargetSet *xTargets,bool hexSearch,
+               int zeroBits,int syncInterval,int syncCount,int pinMode,
+               Int *rangeStart,Int *rangeEnd,int shardIndex,int shardCount,
+               std::string checkpointFile,int cpuGrpSize);
 
   void Search(int nbThread,std::vector<int> gpuId,std::vector<int> gridSize);
   void FindKeyCPU(TH_PARAM *p);
   void FindKeyGPU(TH_PARAM *p);
+  void VerifyHits();
+
+  // Address type searched by a prefix or pattern (NOSTR_NPUB, P2PKH, P2SH or BECH32)
+  static int GetPrefixType(const char *prefix, int length);
+  static int GetPrefixType(const std::string &prefix) { return GetPrefixType(prefix.c_str(), (int)prefix.length()); }
 
 private:
 
   std::string GetHex(std::vector<unsigned char> &buffer);
   std::string GetExpectedTime(double keyRate, double keyCount);
-  bool checkPrivKey(std::string addr, Int &key, int32_t incr, int endomorphism, bool mode);
-  void checkAddr(int prefIdx, uint8_t *hash160, Int &key, int32_t incr, int endomorphism, bool mode);
-  void checkAddrSSE(uint8_t *h1, uint8_t *h2, uint8_t *h3, uint8_t *h4,
-                    int32_t incr1, int32_t incr2, int32_t incr3, int32_t incr4,
-                    Int &key, int endomorphism, bool mode);
-  void checkAddresses(bool compressed, Int key, int i, Point p1);
-  void checkAddressesSSE(bool compressed, Int key, int i, Point p1, Point p2, Point p3, Point p4);
-  void output(std::string addr, std::string pAddr, std::string pAddrHex);
+  void checkPrivKey(const char *addr, Int &key, int32_t incr, int endomorphism, bool mode,
+                    bool *found = NULL, int64_t target = -1, bool counted = true);
+  void verifyHits(HIT_ITEM *hits, int nbHit);
+  void getAddress(Point &p, bool compressed, char *addr);
+  template<int KIND> void checkAddr(int prefIdx, uint8_t *hash160, Int &key, int32_t incr, int endomorphism, bool mode);
+  template<int KIND> void checkHash160SSE(uint8_t *h0, uint8_t *h1, uint8_t *h2, uint8_t *h3,
+                                          int i, int32_t sign, Int &key, int endomorphism, bool mode);
+  template<int KIND, bool COMPRESSED> void checkAddresses(Int &key, int i, Point p1);
+  template<int KIND, bool COMPRESSED> void checkAddressesSSE(Int &key, int i, Point p1, Point p2, Point p3, Point p4);
+  template<int KIND, int MODE, bool SSE> void checkGroup(Int &key, Point *pts, int grpSize);
+  void selectCheckGroup();
+  void checkNpub(Int &key, int i, Point &p);
+  void checkNpub(Int &key, int i, const char *addr);
+  void checkXTarget(Int &key, int i, Point &p);
+  void checkHex(Int &key, int i, Point &p);
+  void checkZeroBits(Int &key, int i, Point &p);
+  void output(const char *addr, const char *pAddr, const char *pAddrHex);
+  void output(const char *addr, Int &key, bool compressed);
   bool isAlive(TH_PARAM *p);
   bool isSingularPrefix(std::string pref);
   bool hasStarted(TH_PARAM *p);
@@ -100,19 +187,32 @@ private:
   uint64_t getGPUCount();
   uint64_t getCPUCount();
   bool initPrefix(std::string &prefix, PREFIX_ITEM *it);
+  bool initPrefix(const char *prefix, int length, PREFIX_ITEM *it);
+  void insertPrefix(PREFIX_ITEM &it);
+  void insertBucket(PREFIX_ITEM &it);
+  void loadPrefixes(PrefixFile *inputFile);
+  void loadTargets(Hash160File *targetFile);
   void dumpPrefixes();
   double getDiffuclty();
   void updateFound();
-  void getCPUStartingKey(int thId, Int& key, Point& startP);
-  void getGPUStartingKeys(int thId, int groupSize, int nbThread, Int *keys, Point *p);
+  void getCPUStartingKey(uint64_t chunk, Int& key, Point& startP, Secp256K1 *secp);
+  template<int GRP_SIZE> void findKeyCPU(TH_PARAM *p);
+  template<int GRP_SIZE> double benchGroup(double duration);
+  void selectGroupSize();
+  void getFoundFlags(std::vector<uint8_t> &flags);
+  void setFoundFlags(std::vector<uint8_t> &flags);
+  void saveCheckpoint();
+  NODE_TABLE *getNodeTable(int node);
+  bool getGPUStartingKeys(int groupSize, int nbThread, uint64_t *blocks, Int *keys, Point *p);
   void enumCaseUnsentivePrefix(std::string s, std::vector<std::string> &list);
-  bool prefixMatch(char *prefix, char *addr);
+  bool prefixMatch(const char *prefix, int length, const char *addr);
 
   Secp256K1 *secp;
   Int startKey;
   Point startPubKey;
   bool startPubKeySpecified;
-  uint64_t counters[256];
+  ThreadRegistry registry;
+  KeyScheduler sched;
   double startTime;
   int searchType;
   int searchMode;
@@ -126,8 +226,17 @@ private:
   int nbFoundKey;
   uint64_t rekey;
   uint64_t lastRekey;
+  bool keyBounded;     // -keyspace or -shard, keys from startKey to keyEnd
+  Int keyEnd;
+  uint64_t nbKeyChunk; // Chunks of the keyspace, KEY_UNBOUNDED if too large
+  std::string checkpointFile;
+  uint8_t checkpointKey[32];
+  bool resumed;
+  uint64_t resumedKeys;
+  std::vector<KEY_RANGE> resumedRanges;
   uint32_t nbPrefix;
   std::string outputFile;
+  ResultWriter *writer;
   bool useSSE;
   bool onlyFull;
   uint32_t maxFound;
@@ -135,18 +244,45 @@ private:
   bool *patternFound;
   std::vector<PREFIX_TABLE_ITEM> prefixes;
   std::vector<prefix_t> usedPrefix;
+  std::vector<HASH160_MASK> bech32Masks;
+  std::vector<XONLY_MASK> hexMasks;
+  int zeroBits;       // Leading zero bits of X to reach (-lz), 0 if disabled
+  int zeroFloor;      // Best results are output from this number of bits
+  volatile int zeroBest;
+  volatile uint64_t zeroLimit; // Top limb of X below which the bits are counted
+  PatternAutomaton patterns;
   std::vector<LPREFIX> usedPrefixL;
   std::vector<std::string> &inputPrefixes;
+  Hash160File *targetFile;
+  std::vector<PREFIX_ITEM> targetItems;
+  NostrTargetSet *xTargets;
+  std::vector<std::string> npubSuffixes;   // npub patterns without "npub1"
+  void (VanitySearch::*checkGroupFunc)(Int &key, Point *pts, int grpSize);
+  void (VanitySearch::*checkAddrFunc)(int prefIdx, uint8_t *hash160, Int &key, int32_t incr, int endomorphism, bool mode);
+  int keyPerPoint;    // Keys checked per point of a group (endomorphisms, symmetry)
+  bool calibrating;   // Group size calibration, hits are dropped
+  uint8_t base58Version; // Version byte of the P2PKH or P2SH patterns
 
   Int beta;
   Int lambda;
   Int beta2;
   Int lambda2;
 
+  std::vector<HIT_ITEM> hits;  // Queued by the search threads (hitMutex)
+  uint64_t nbHitQueued;        // (hitMutex)
+  volatile uint64_t nbHitDone;
+  bool endOfHits;
+  volatile bool verifierRunning;
+  int pinMode;
+  int cpuGrpSize;     // Keys per CPU group, 0 until calibrated
+  std::vector<NODE_TABLE *> nodeTables;
+
 #ifdef WIN64
-  HANDLE ghMutex;
+  HANDLE hitMutex;
+  HANDLE nodeMutex;
 #else
-  pthread_mutex_t  ghMutex;
+  pthread_mutex_t  hitMutex;
+  pthread_mutex_t  nodeMutex;
 #endif
 
 };
@@ -364,22 +364,6 @@ inline uint32_t _rotr(uint32_t x, uint8_t r) {
 
 ////// SHA-256
 
-class CSHA256
-{
-private:
-    uint32_t s[8];
-    unsigned char buf[64];
-    uint64_t bytes;
-
-public:
-    static const size_t OUTPUT_SIZE = 32;
-
-    CSHA256();
-    void Write(const unsigned char* data, size_t len);
-    void Finalize(unsigned char hash[OUTPUT_SIZE]);
-
-};
-
 CSHA256::CSHA256() {
     bytes = 0;
     s[0] = 0x6a09e667ul;
@@ -496,7 +480,10 @@ void sha256_checksum(uint8_t *input, int length, uint8_t *checksum) {
   uint8_t b[64];
   memcpy(b,input,length);
   memcpy(b + length, _sha256::pad, 56-length);
-  WRITEBE64(b + 56, length << 3);
+  // Bit length copied bytewise, a 64 bit store would not be seen by the
+  // 32 bit loads of Transform2() under strict aliasing
+  uint64_t bitLength = _byteswap_uint64((uint64_t)length << 3);
+  memcpy(b + 56, &bitLength, 8);
   _sha256::Transform2(s, b);
   WRITEBE32(checksum,s[0]);
 
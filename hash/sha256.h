@@ -18,6 +18,25 @@
 #ifndef SHA256_H
 #define SHA256_H
 #include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+// Incremental SHA-256
+class CSHA256
+{
+private:
+    uint32_t s[8];
+    unsigned char buf[64];
+    uint64_t bytes;
+
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    CSHA256();
+    void Write(const unsigned char* data, size_t len);
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+
+};
 
 void sha256(uint8_t *input,int length, uint8_t *digest);
 void sha256_33(uint8_t *input, uint8_t *digest);
@@ -36,10 +36,15 @@ void printUsage() {
 
   printf("VanitySearchNostr [-check] [-v] [-u] [-b] [-c] [-gpu] [-stop] [-i inputfile]\n");
   printf("                  [-gpuId gpuId1[,gpuId2,...]] [-g g1x,g1y,[,g2x,g2y,...]]\n");
-  printf("                  [-o outputfile] [-m maxFound] [-ps seed] [-s seed] [-t nbThread]\n");
-  printf("                  [-nosse] [-r rekey] [-check] [-kp] [-sp startPubKey]\n");
-  printf("                  [-rp privkey partialkeyfile] [npub_prefix]\n\n");
+  printf("                  [-o outputfile] [-fsync interval,count] [-m maxFound] [-ps seed] [-s seed] [-t nbThread]\n");
+  printf("                  [-nosse] [-pin cores|smt] [-grp size] [-r rekey] [-check] [-kp] [-sp startPubKey]\n");
+  printf("                  [-keyspace start:end] [-shard index/count] [-resume checkpointfile]\n");
+  printf("                  [-rp privkey partialkeyfile] [-snapshot file] [-ih hash160file]\n");
+  printf("                  [-convert addressfile hash160file] [-ix pubkeyfile] [-hex] [-lz nbBit]\n");
+  printf("                  [npub_prefix]\n\n");
   printf(" npub_prefix: Nostr npub prefix to search (Can contains wildcard '?' or '*')\n");
+  printf(" -hex: Search hex x-only public keys, prefixes are hex digits with '?' and one '*' (e.g. dead*beef)\n");
+  printf(" -lz nbBit: Search an x-only public key with nbBit leading zero bits, the best one is reported\n");
   printf(" -v: Print version\n");
   printf(" -u: Search uncompressed addresses\n");
   printf(" -b: Search both uncompressed or compressed addresses\n");
@@ -47,7 +52,12 @@ void printUsage() {
   printf(" -gpu: Enable gpu calculation\n");
   printf(" -stop: Stop when all prefixes are found\n");
   printf(" -i inputfile: Get list of prefixes to search from specified file\n");
+  printf(" -snapshot file: Save the lookup tables to file, reload them on next start if the input is unchanged\n");
+  printf(" -ih hash160file: Search the full addresses of a binary hash160 list (see -convert)\n");
+  printf(" -convert addressfile hash160file: Convert a list of addresses to a sorted binary hash160 list\n");
+  printf(" -ix pubkeyfile: Search exact x-only public keys (64 hex digits or npub, one per line), CPU only\n");
   printf(" -o outputfile: Output results to the specified file\n");
+  printf(" -fsync interval,count: Sync the output file every interval seconds or count results, default is 1,64\n");
   printf(" -gpu gpuId1,gpuId2,...: List of GPU(s) to use, default is 0\n");
   printf(" -g g1x,g1y,g2x,g2y, ...: Specify GPU(s) kernel gridsize, default is 8*(MP number),128\n");
   printf(" -m: Specify maximun number of prefixes found by each kernel call\n");
@@ -55,6 +65,9 @@ void printUsage() {
   printf(" -ps seed: Specify a seed concatened with a crypto secure random seed\n");
   printf(" -t threadNumber: Specify number of CPU thread, default is number of core\n");
   printf(" -nosse: Disable SSE hash function\n");
+  printf(" -pin cores|smt: Pin CPU threads, one per physical core first (cores) or SMT siblings together (smt)\n");
+  printf(" -grp size: CPU group size (128, 256, 288, 512, 1024, 2048 or 4096), default is the fastest one\n");
+  printf("            measured at startup\n");
   printf(" -l: List cuda enabled devices\n");
   printf(" -check: Check CPU and GPU kernel vs CPU\n");
   printf(" -cp privKey: Compute public key (privKey in hex hormat)\n");
@@ -63,6 +76,11 @@ void printUsage() {
   printf(" -rp privkey partialkeyfile: Reconstruct final private key(s) from partial key(s) info.\n");
   printf(" -sp startPubKey: Start the search with a pubKey (for private key splitting)\n");
   printf(" -r rekey: Rekey interval in MegaKey, default is disabled\n");
+  printf(" -keyspace start:end: Walk the private keys from start to end (hex, end excluded) and stop\n");
+  printf(" -shard index/count: Walk the shard index (0 to count-1) of the -keyspace range, the shards of\n");
+  printf("                     a same range are disjoint\n");
+  printf(" -resume checkpointfile: Save the search position every minute and on exit (SIGINT/SIGTERM included),\n");
+  printf("                         restart from it when the file exists\n");
   exit(0);
 
 }
@@ -375,7 +393,7 @@ int main(int argc, char* argv[]) {
   // Construct Secp object (heavy initは後で)
   Secp256K1 *secp = new Secp256K1();
 
-  // Early startup logs and "早期バリデーション"（重い初期化の前に実行）
+  // Early startup logs
   printf("VanitySearch v%s\n", RELEASE);
   {
     time_t now = time(NULL);
@@ -383,30 +401,6 @@ int main(int argc, char* argv[]) {
     if (ct) printf("Start %s", ct);
   }
 
-  // Argに単一プレフィックスが与えられている典型ケースでは、npubパターンを事前検証
-  if (argc >= 2) {
-    const std::string bech32chars = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
-    std::string lastArg = std::string(argv[argc - 1]);
-    if (!lastArg.empty() && lastArg[0] != '-') {
-      // npub接頭辞有無でサフィックスを抽出
-      bool hasNpub = (lastArg.rfind("npub", 0) == 0);
-      std::string suffix = hasNpub ? lastArg.substr(4) : lastArg;
-      if (!suffix.empty() && suffix[0] == '1') suffix.erase(0, 1);
-      bool ok = true;
-      for (size_t i = 0; i < suffix.size() && ok; ++i) {
-        char c = suffix[i];
-        if (c == '*' || c == '?') continue;
-        if ((char)tolower(c) != c) ok = false;
-        else if (bech32chars.find(c) == std::string::npos) ok = false;
-      }
-      if (!ok) {
-        printf("Error: Invalid npub prefix '%s' (allowed chars: %s, wildcards: ? *)\n",
-               lastArg.c_str(), bech32chars.c_str());
-        exit(-1);
-      }
-    }
-  }
-
   printf("Initializing secp256k1...\n");
   fflush(stdout);
   secp->Init();
@@ -425,6 +419,10 @@ int main(int argc, char* argv[]) {
   vector<int> gridSize;
   string seed = "";
   vector<string> prefix;
+  string inputFileName = "";
+  string snapshotFile = "";
+  string targetFileName = "";
+  string xTargetFileName = "";
   string outputFile = "";
   int nbCPUThread = Timer::getCoreNumber();
   bool tSpecified = false;
@@ -436,6 +434,18 @@ int main(int argc, char* argv[]) {
   bool startPubKeyCompressed;
   bool caseSensitive = true;
   bool paranoiacSeed = false;
+  bool hexSearch = false;
+  int zeroBits = 0;
+  int syncInterval = 1;
+  int syncCount = 64;
+  int pinMode = PIN_NONE;
+  int cpuGrpSize = 0;
+  Int rangeStart;
+  Int rangeEnd;
+  bool keyspace = false;
+  int shardIndex = 0;
+  int shardCount = 1;
+  string checkpointFile = "";
 
   while (a < argc) {
 
@@ -545,9 +555,101 @@ int main(int argc, char* argv[]) {
       a++;
       outputFile = string(argv[a]);
       a++;
+    } else if (strcmp(argv[a], "-pin") == 0) {
+      a++;
+      if (strcmp(argv[a], "cores") == 0) {
+        pinMode = PIN_CORES;
+      } else if (strcmp(argv[a], "smt") == 0) {
+        pinMode = PIN_SMT;
+      } else {
+        printf("Invalid pin argument, cores or smt expected\n");
+        exit(-1);
+      }
+      a++;
+    } else if (strcmp(argv[a], "-grp") == 0) {
+      a++;
+      cpuGrpSize = getInt("grp", argv[a]);
+      if (cpuGrpSize != 128 && cpuGrpSize != 256 && cpuGrpSize != 288 && cpuGrpSize != 512 &&
+          cpuGrpSize != 1024 && cpuGrpSize != 2048 && cpuGrpSize != 4096) {
+        printf("Invalid grp argument, 128, 256, 288, 512, 1024, 2048 or 4096 expected\n");
+        exit(-1);
+      }
+      a++;
+    } else if (strcmp(argv[a], "-fsync") == 0) {
+      a++;
+      vector<int> sync;
+      getInts("fsync", sync, string(argv[a]), ',');
+      if (sync.size() != 2 || sync[0] < 0 || sync[1] < 0) {
+        printf("Invalid fsync argument, interval,count expected\n");
+        exit(-1);
+      }
+      syncInterval = sync[0];
+      syncCount = sync[1];
+      a++;
+    } else if (strcmp(argv[a], "-keyspace") == 0) {
+      a++;
+      string range = string(argv[a]);
+      size_t sep = range.find(':');
+      if (sep == string::npos || sep == 0 || sep == range.length() - 1 ||
+          range.find_first_not_of("0123456789abcdefABCDEF:") != string::npos || sep > 64 || range.length() - sep - 1 > 64) {
+        printf("Invalid keyspace argument, start:end (hex) expected\n");
+        exit(-1);
+      }
+      rangeStart.SetBase16((char *)range.substr(0, sep).c_str());
+      rangeEnd.SetBase16((char *)range.substr(sep + 1).c_str());
+      if (rangeStart.IsZero() || rangeStart.IsGreaterOrEqual(&rangeEnd) || rangeEnd.IsGreater(&secp->order)) {
+        printf("Invalid keyspace argument, 0 < start < end <= order expected\n");
+        exit(-1);
+      }
+      keyspace = true;
+      a++;
+    } else if (strcmp(argv[a], "-shard") == 0) {
+      a++;
+      vector<int> shard;
+      getInts("shard", shard, string(argv[a]), '/');
+      if (shard.size() != 2 || shard[1] < 1 || shard[1] > 1048576 || shard[0] < 0 || shard[0] >= shard[1]) {
+        printf("Invalid shard argument, index/count expected with 0 <= index < count\n");
+        exit(-1);
+      }
+      shardIndex = shard[0];
+      shardCount = shard[1];
+      a++;
+    } else if (strcmp(argv[a], "-resume") == 0) {
+      a++;
+      checkpointFile = string(argv[a]);
+      a++;
     } else if (strcmp(argv[a], "-i") == 0) {
       a++;
-      parseFile(string(argv[a]),prefix);
+      inputFileName = string(argv[a]);
+      a++;
+    } else if (strcmp(argv[a], "-ih") == 0) {
+      a++;
+      targetFileName = string(argv[a]);
+      a++;
+    } else if (strcmp(argv[a], "-ix") == 0) {
+      a++;
+      xTargetFileName = string(argv[a]);
+      a++;
+    } else if (strcmp(argv[a], "-lz") == 0) {
+      a++;
+      zeroBits = getInt("nbBit", argv[a]);
+      if (zeroBits < 1 || zeroBits > 255) {
+        printf("Invalid nbBit argument, must be in [1,255]\n");
+        exit(-1);
+      }
+      a++;
+    } else if (strcmp(argv[a], "-hex") == 0) {
+      hexSearch = true;
+      a++;
+    } else if (strcmp(argv[a], "-convert") == 0) {
+      a++;
+      string in = string(argv[a]);
+      a++;
+      Hash160File::Convert(in, string(argv[a]));
+      exit(0);
+    } else if (strcmp(argv[a], "-snapshot") == 0) {
+      a++;
+      snapshotFile = string(argv[a]);
       a++;
     } else if (strcmp(argv[a], "-t") == 0) {
       a++;
@@ -576,6 +678,27 @@ int main(int argc, char* argv[]) {
 
   printf("VanitySearch v" RELEASE "\n");
 
+  // npubパターンを事前検証（オプション解析後、最後の引数がプレフィックスの場合）
+  if (prefix.size() == 1 && !hexSearch && VanitySearch::GetPrefixType(prefix[0]) == NOSTR_NPUB) {
+    const std::string bech32chars = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+    // npub接頭辞有無でサフィックスを抽出
+    bool hasNpub = (prefix[0].rfind("npub", 0) == 0);
+    std::string suffix = hasNpub ? prefix[0].substr(4) : prefix[0];
+    if (!suffix.empty() && suffix[0] == '1') suffix.erase(0, 1);
+    bool ok = true;
+    for (size_t i = 0; i < suffix.size() && ok; ++i) {
+      char c = suffix[i];
+      if (c == '*' || c == '?') continue;
+      if ((char)tolower(c) != c) ok = false;
+      else if (bech32chars.find(c) == std::string::npos) ok = false;
+    }
+    if (!ok) {
+      printf("Error: Invalid npub prefix '%s' (allowed chars: %s, wildcards: ? *)\n",
+             prefix[0].c_str(), bech32chars.c_str());
+      exit(-1);
+    }
+  }
+
   if(gridSize.size()==0) {
     for (int i = 0; i < gpuId.size(); i++) {
       gridSize.push_back(-1);
@@ -598,8 +721,61 @@ int main(int argc, char* argv[]) {
     searchMode = (startPubKeyCompressed)?SEARCH_COMPRESSED:SEARCH_UNCOMPRESSED;
   }
 
+  // Input file is mapped and indexed in parallel, pattern lists are
+  // matched as strings so they are materialized here
+  PrefixFile *inputFile = NULL;
+  if (inputFileName.length() > 0) {
+    inputFile = new PrefixFile(inputFileName, Timer::getCoreNumber());
+    if (inputFile->hasPattern || prefix.size() > 0 || hexSearch) {
+      inputFile->GetLines(prefix);
+      delete inputFile;
+      inputFile = NULL;
+    }
+  }
+
+  Hash160File *targetFile = NULL;
+  if (targetFileName.length() > 0) {
+    if (prefix.size() > 0 || inputFile || hexSearch) {
+      printf("Error: -ih cannot be combined with other prefixes\n");
+      exit(-1);
+    }
+    targetFile = new Hash160File(targetFileName);
+  }
+
+  if (zeroBits > 0 && (prefix.size() > 0 || inputFile || targetFile || hexSearch || xTargetFileName.length() > 0)) {
+    printf("Error: -lz cannot be combined with prefixes\n");
+    exit(-1);
+  }
+
+  NostrTargetSet *xTargets = NULL;
+  if (xTargetFileName.length() > 0) {
+    if (prefix.size() > 0 || inputFile || targetFile || hexSearch) {
+      printf("Error: -ix cannot be combined with other prefixes\n");
+      exit(-1);
+    }
+    if (gpuEnable) {
+      printf("Error: -ix is not supported on GPU\n");
+      exit(-1);
+    }
+    xTargets = new NostrTargetSet(xTargetFileName, Timer::getCoreNumber());
+  }
+
+  // Without a range, the base key is random and the shards of different
+  // hosts would overlap
+  if (shardCount > 1 && !keyspace) {
+    printf("Error: -shard needs -keyspace\n");
+    exit(-1);
+  }
+
+  if (rekey > 0 && (keyspace || shardCount > 1 || checkpointFile.length() > 0)) {
+    printf("Error: -r cannot be combined with -keyspace, -shard or -resume\n");
+    exit(-1);
+  }
+
   VanitySearch *v = new VanitySearch(secp, prefix, seed, searchMode, gpuEnable, stop, outputFile, sse,
-    maxFound, rekey, caseSensitive, startPuKey, paranoiacSeed);
+    maxFound, rekey, caseSensitive, startPuKey, paranoiacSeed, inputFile, snapshotFile, targetFile, xTargets, hexSearch, zeroBits,
+    syncInterval, syncCount, pinMode, keyspace ? &rangeStart : NULL, keyspace ? &rangeEnd : NULL,
+    shardIndex, shardCount, checkpointFile, cpuGrpSize);
   v->Search(nbCPUThread,gpuId,gridSize);
 
   return 0;
@@ -0,0 +1,145 @@
+// Test and benchmark of the fixed width and leading digits base58 encoders
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include "Base58.h"
+#include "Timer.h"
+
+static void randomPayload(unsigned char *p, int size, int nbZero) {
+
+    for (int i = 0; i < size; i++)
+        p[i] = (i < nbZero) ? 0 : (unsigned char)(rand() & 0xFF);
+
+}
+
+// Same output as the generic encoder, including leading zero bytes
+static bool test_equal(int size) {
+
+    unsigned char p[40];
+    char out[64];
+    for (int i = 0; i < 100000; i++) {
+        // All zero payloads are excluded, the generic encoder outputs an extra digit
+        randomPayload(p, size, rand() % 4 == 0 ? rand() % size : 0);
+        p[size - 1] |= 1;
+        std::string ref = EncodeBase58(p, p + size);
+        int len = EncodeBase58(p, p + size, out);
+        if (len != (int)ref.length() || ref != out) {
+            std::cout << "  FAIL size " << size << ": " << out << " != " << ref << std::endl;
+            return false;
+        }
+    }
+    std::cout << "  " << size << " bytes: OK" << std::endl;
+    return true;
+
+}
+
+// Leading digits, up to the whole encoding, are the ones of the full encoder
+static bool test_leading() {
+
+    unsigned char p[25];
+    char out[64];
+    char lead[64];
+    Base58Leading b;
+    for (int i = 0; i < 100000; i++) {
+        randomPayload(p, 25, rand() % 4 == 0 ? rand() % 25 : 0);
+        p[24] |= 1;
+        EncodeBase58(p, p + 25, out);
+        b.Set(p);
+        int n = 0;
+        while ((lead[n] = b.Next()) != 0)
+            n++;
+        if (strcmp(lead, out) != 0) {
+            std::cout << "  FAIL leading: " << lead << " != " << out << std::endl;
+            return false;
+        }
+    }
+    std::cout << "  leading digits: OK" << std::endl;
+    return true;
+
+}
+
+static void bench_leading(int nbChar) {
+
+    const int nbPayload = 1024;
+    const int nbLoop = 500;
+    unsigned char *p = new unsigned char[nbPayload * 25];
+    randomPayload(p, nbPayload * 25, 0);
+    for (int i = 0; i < nbPayload; i++)
+        p[i * 25] = 0;
+    char out[64];
+    size_t check = 0;
+    Base58Leading b;
+
+    double t0 = Timer::get_tick();
+    for (int l = 0; l < nbLoop; l++)
+        for (int i = 0; i < nbPayload; i++)
+            check += EncodeBase58(p + i * 25, p + (i + 1) * 25, out);
+    double t1 = Timer::get_tick();
+    for (int l = 0; l < nbLoop; l++)
+        for (int i = 0; i < nbPayload; i++) {
+            b.Set(p + i * 25);
+            for (int j = 0; j < nbChar; j++)
+                check += b.Next();
+        }
+    double t2 = Timer::get_tick();
+
+    double n = (double)nbPayload * nbLoop;
+    printf("  %d leading chars: fixed %.1f ns, leading %.1f ns (x%.1f) [%zu]\n", nbChar,
+           (t1 - t0) * 1e9 / n, (t2 - t1) * 1e9 / n, (t1 - t0) / (t2 - t1), check);
+    delete[] p;
+
+}
+
+static void bench(int size) {
+
+    const int nbPayload = 1024;
+    const int nbLoop = 500;
+    unsigned char *p = new unsigned char[nbPayload * size];
+    randomPayload(p, nbPayload * size, 0);
+    char out[64];
+    size_t check = 0;
+
+    double t0 = Timer::get_tick();
+    for (int l = 0; l < nbLoop; l++)
+        for (int i = 0; i < nbPayload; i++)
+            check += EncodeBase58(p + i * size, p + (i + 1) * size).length();
+    double t1 = Timer::get_tick();
+    for (int l = 0; l < nbLoop; l++)
+        for (int i = 0; i < nbPayload; i++)
+            check += EncodeBase58(p + i * size, p + (i + 1) * size, out);
+    double t2 = Timer::get_tick();
+
+    double n = (double)nbPayload * nbLoop;
+    printf("  %d bytes: generic %.1f ns, fixed %.1f ns (x%.1f) [%zu]\n", size,
+           (t1 - t0) * 1e9 / n, (t2 - t1) * 1e9 / n, (t1 - t0) / (t2 - t1), check);
+    delete[] p;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing fixed width Base58 ===" << std::endl;
+    srand(12345);
+    Timer::Init();
+
+    bool ok = true;
+    ok &= test_equal(25);
+    ok &= test_equal(37);
+    ok &= test_equal(38);
+    ok &= test_equal(21);
+    char out[64];
+    unsigned char big[41] = { 0 };
+    ok &= EncodeBase58(big, big + 41, out) == -1;
+    ok &= test_leading();
+
+    bench(25);
+    bench(37);
+    bench(38);
+    bench_leading(2);
+    bench_leading(5);
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
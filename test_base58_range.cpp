@@ -0,0 +1,154 @@
+// Test case for the base58 prefix to hash160 interval matcher
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include "Base58Range.h"
+#include "Base58.h"
+#include "SECP256k1.h"
+#include "hash/sha256.h"
+
+static std::string encodeAddress(int type, const uint8_t *h160) {
+
+    uint8_t a[25];
+    uint8_t d1[32];
+    uint8_t d2[32];
+    a[0] = (type == P2PKH) ? 0x00 : 0x05;
+    memcpy(a + 1, h160, 20);
+    sha256(a, 21, d1);
+    sha256(d1, 32, d2);
+    memcpy(a + 21, d2, 4);
+    return EncodeBase58(a, a + 25);
+
+}
+
+static void randomHash160(uint8_t *h, int nbZero) {
+
+    for (int i = 0; i < 20; i++)
+        h[i] = (i < nbZero) ? 0 : (uint8_t)(rand() & 0xFF);
+
+}
+
+// Every hash160 encoding to the prefix must be in the intervals, hash160
+// in the intervals and not encoding to the prefix must be at a bound
+static bool test_prefix(int type, const std::string &prefix, int nbZero) {
+
+    std::vector<HASH160_RANGE> r;
+    if (!Base58Range::Compile(prefix.c_str(), (int)prefix.length(), type, r)) {
+        std::cout << "  FAIL compile " << prefix << std::endl;
+        return false;
+    }
+
+    int nbMatch = 0;
+    int nbFalse = 0;
+    for (int i = 0; i < 200000; i++) {
+        uint8_t h[20];
+        randomHash160(h, nbZero);
+        std::string addr = encodeAddress(type, h);
+        bool inRange = Base58Range::Match(r.data(), (int)r.size(), h);
+        bool isPrefix = addr.compare(0, prefix.length(), prefix) == 0;
+        if (isPrefix && !inRange) {
+            std::cout << "  FAIL " << prefix << " missed " << addr << std::endl;
+            return false;
+        }
+        nbMatch += isPrefix;
+        nbFalse += (inRange && !isPrefix);
+    }
+
+    std::cout << "  " << prefix << ": " << r.size() << " range(s), " << nbMatch << " match, "
+              << nbFalse << " false positive" << std::endl;
+    return nbFalse <= 2;
+
+}
+
+static bool equalNoCase(const std::string &a, const std::string &b, size_t n) {
+
+    for (size_t i = 0; i < n; i++)
+        if (tolower(a[i]) != tolower(b[i]))
+            return false;
+    return true;
+
+}
+
+// Case unsensitive prefix, no miss and few extra hits to confirm
+static bool test_case_unsensitive(int type, const std::string &prefix) {
+
+    std::vector<HASH160_RANGE> r;
+    if (!Base58Range::Compile(prefix.c_str(), (int)prefix.length(), type, r, false)) {
+        std::cout << "  FAIL compile " << prefix << std::endl;
+        return false;
+    }
+
+    int nbMatch = 0;
+    int nbExtra = 0;
+    for (int i = 0; i < 200000; i++) {
+        uint8_t h[20];
+        randomHash160(h, 0);
+        std::string addr = encodeAddress(type, h);
+        bool inRange = Base58Range::Match(r.data(), (int)r.size(), h);
+        bool isPrefix = equalNoCase(addr, prefix, prefix.length());
+        if (isPrefix && !inRange) {
+            std::cout << "  FAIL " << prefix << " missed " << addr << std::endl;
+            return false;
+        }
+        nbMatch += isPrefix;
+        nbExtra += (inRange && !isPrefix);
+    }
+
+    std::cout << "  " << prefix << " (case unsensitive): " << r.size() << " range(s), " << nbMatch << " match, "
+              << nbExtra << " to confirm" << std::endl;
+    return nbExtra <= nbMatch + 10;
+
+}
+
+// The address of a random hash160 truncated to n chars always matches
+static bool test_own_prefix(int type) {
+
+    for (int i = 0; i < 2000; i++) {
+        uint8_t h[20];
+        randomHash160(h, rand() % 3);
+        std::string addr = encodeAddress(type, h);
+        std::string prefix = addr.substr(0, 2 + rand() % 8);
+        std::vector<HASH160_RANGE> r;
+        if (!Base58Range::Compile(prefix.c_str(), (int)prefix.length(), type, r) ||
+            !Base58Range::Match(r.data(), (int)r.size(), h)) {
+            std::cout << "  FAIL own prefix " << prefix << " of " << addr << std::endl;
+            return false;
+        }
+    }
+    return true;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing Base58Range ===" << std::endl;
+    srand(12345);
+
+    bool ok = true;
+    ok &= test_prefix(P2PKH, "1A", 0);
+    ok &= test_prefix(P2PKH, "1Ab", 0);
+    ok &= test_prefix(P2PKH, "1z", 0);
+    ok &= test_prefix(P2PKH, "12", 0);
+    ok &= test_prefix(P2PKH, "11", 1);
+    ok &= test_prefix(P2PKH, "11B", 1);
+    ok &= test_prefix(P2SH, "3A", 0);
+    ok &= test_prefix(P2SH, "3Q", 0);
+    ok &= test_case_unsensitive(P2PKH, "1ab");
+    ok &= test_case_unsensitive(P2PKH, "1kid");
+    ok &= test_case_unsensitive(P2SH, "3Mab");
+    ok &= test_own_prefix(P2PKH);
+    ok &= test_own_prefix(P2SH);
+
+    // 2^20 spellings, compiled to a bounded number of ranges
+    std::vector<HASH160_RANGE> r;
+    ok &= Base58Range::Compile("1abcdefghjkmnpqrstuvw", 21, P2PKH, r, false) && r.size() <= 4 * MAX_EXPANSION;
+    ok &= !Base58Range::Compile("2A", 2, P2PKH, r);
+    ok &= !Base58Range::Compile("1A", 2, P2SH, r);
+    ok &= !Base58Range::Compile("1I", 2, P2PKH, r);
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
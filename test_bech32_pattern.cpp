@@ -0,0 +1,117 @@
+// Test case for the bc1q pattern to hash160 mask compiler
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include "Bech32Pattern.h"
+#include "Bech32.h"
+#include "Wildcard.h"
+
+static std::string encodeAddress(const uint8_t *h160) {
+
+    char out[128];
+    segwit_addr_encode(out, "bc", 0, h160, 20);
+    return std::string(out);
+
+}
+
+static void randomHash160(uint8_t *h) {
+
+    for (int i = 0; i < 20; i++)
+        h[i] = (uint8_t)(rand() & 0xFF);
+
+}
+
+// The mask never rejects a matching address, and accepts only matching ones
+// when the pattern has no checksum character
+static bool test_pattern(const std::string &pattern, bool exact) {
+
+    HASH160_MASK m;
+    if (!Bech32Pattern::Compile(pattern.c_str(), (int)pattern.length(), false, m)) {
+        std::cout << "  FAIL compile " << pattern << std::endl;
+        return false;
+    }
+
+    int nbMatch = 0;
+    int nbExtra = 0;
+    for (int i = 0; i < 500000; i++) {
+        uint8_t h[20];
+        randomHash160(h);
+        // Bias half of the hash160 towards the mask value
+        if (i & 1)
+            for (int j = 0; j < 20; j++)
+                h[j] = (h[j] & ~m.mask[j]) | m.value[j];
+        std::string addr = encodeAddress(h);
+        bool isMatch = Wildcard::match(addr.c_str(), pattern.c_str(), true);
+        bool inMask = Bech32Pattern::Match(m, h);
+        if (isMatch && !inMask) {
+            std::cout << "  FAIL " << pattern << " missed " << addr << std::endl;
+            return false;
+        }
+        nbMatch += isMatch;
+        nbExtra += (inMask && !isMatch);
+    }
+
+    std::cout << "  " << pattern << ": " << Bech32Pattern::NbBit(m) << " bits, " << nbMatch << " match, "
+              << nbExtra << " to confirm" << std::endl;
+    return nbMatch > 0 && (!exact || nbExtra == 0);
+
+}
+
+// A prefix is one interval containing exactly the masked hash160
+static bool test_prefix(const std::string &prefix) {
+
+    HASH160_MASK m;
+    HASH160_RANGE r;
+    if (!Bech32Pattern::Compile(prefix.c_str(), (int)prefix.length(), true, m) || !Bech32Pattern::ToRange(m, r))
+        return false;
+    for (int i = 0; i < 100000; i++) {
+        uint8_t h[20];
+        randomHash160(h);
+        if (i & 1)
+            for (int j = 0; j < 20; j++)
+                h[j] = (h[j] & ~m.mask[j]) | m.value[j];
+        bool inRange = memcmp(h, r.lo, 20) >= 0 && memcmp(h, r.hi, 20) <= 0;
+        if (inRange != (encodeAddress(h).compare(0, prefix.length(), prefix) == 0)) {
+            std::cout << "  FAIL prefix " << prefix << std::endl;
+            return false;
+        }
+    }
+    std::cout << "  " << prefix << ": prefix OK" << std::endl;
+    return true;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing Bech32Pattern ===" << std::endl;
+    srand(12345);
+
+    bool ok = true;
+    ok &= test_pattern("bc1qxy*", true);
+    ok &= test_pattern("bc1q?p?z*", true);
+    ok &= test_pattern("bc1qqq*ac", false);
+    ok &= test_pattern("bc1?a*", true);
+    ok &= test_prefix("bc1qxyz");
+    ok &= test_prefix("bc1qa");
+
+    // 16 bits prefixes allowed by the mask
+    HASH160_MASK m;
+    std::vector<uint16_t> p;
+    Bech32Pattern::Compile("bc1qx", 5, true, m);
+    Bech32Pattern::GetPrefixes(m, p);
+    ok &= p.size() == 2048;
+    Bech32Pattern::Compile("bc1qxyzw", 8, true, m);
+    Bech32Pattern::GetPrefixes(m, p);
+    ok &= p.size() == 1;
+
+    HASH160_RANGE r;
+    ok &= Bech32Pattern::Compile("bc1q?x*", 7, false, m) && !Bech32Pattern::ToRange(m, r);
+    ok &= !Bech32Pattern::Compile("bc1pxy*", 7, false, m);
+    ok &= !Bech32Pattern::Compile("bc1qb*", 6, false, m);
+    ok &= !Bech32Pattern::Compile("bc1qxy", 6, false, m);
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
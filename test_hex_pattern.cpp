@@ -0,0 +1,91 @@
+// Test case for the hex x-only public key pattern masks
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include "HexPattern.h"
+
+static std::string toHex(const uint64_t *x) {
+
+    char s[65];
+    snprintf(s, sizeof(s), "%016llx%016llx%016llx%016llx", (unsigned long long)x[3], (unsigned long long)x[2],
+             (unsigned long long)x[1], (unsigned long long)x[0]);
+    return std::string(s);
+
+}
+
+// Reference matcher on the hex string
+static bool refMatch(const std::string &hex, const std::string &pattern) {
+
+    size_t star = pattern.find('*');
+    std::string pre = pattern.substr(0, star);
+    std::string suf = (star == std::string::npos) ? "" : pattern.substr(star + 1);
+    for (size_t i = 0; i < pre.size(); i++)
+        if (pre[i] != '?' && tolower(pre[i]) != hex[i])
+            return false;
+    for (size_t i = 0; i < suf.size(); i++)
+        if (suf[i] != '?' && tolower(suf[i]) != hex[64 - suf.size() + i])
+            return false;
+    return true;
+
+}
+
+static uint64_t rand64() {
+
+    return ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+
+}
+
+// Mask matching agrees with the string matcher, on random and on matching X
+static bool test_pattern(const std::string &pattern) {
+
+    XONLY_MASK m;
+    if (!HexPattern::Compile(pattern.c_str(), (int)pattern.length(), m)) {
+        std::cout << "  FAIL compile " << pattern << std::endl;
+        return false;
+    }
+
+    int nbMatch = 0;
+    for (int i = 0; i < 200000; i++) {
+        uint64_t x[4] = { rand64(), rand64(), rand64(), rand64() };
+        if (i & 1)
+            for (int j = 0; j < 4; j++)
+                x[j] = (x[j] & ~m.mask[j]) | m.value[j];
+        bool ok = HexPattern::Match(m, x);
+        if (ok != refMatch(toHex(x), pattern)) {
+            std::cout << "  FAIL " << pattern << " on " << toHex(x) << std::endl;
+            return false;
+        }
+        nbMatch += ok;
+    }
+
+    std::cout << "  " << pattern << ": " << HexPattern::NbBit(m) << " bits, " << nbMatch << " match" << std::endl;
+    return nbMatch >= 100000;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing HexPattern ===" << std::endl;
+    srand(12345);
+
+    bool ok = true;
+    ok &= test_pattern("dead");
+    ok &= test_pattern("DeadBeef");
+    ok &= test_pattern("0?0");
+    ok &= test_pattern("*beef");
+    ok &= test_pattern("cafe*f00d");
+    ok &= test_pattern("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+    ok &= test_pattern("0123456789abcdef0123456789abcdef*0123456789abcdef0123456789abcdef");
+
+    XONLY_MASK m;
+    ok &= !HexPattern::Compile("xyz", 3, m);
+    ok &= !HexPattern::Compile("a*b*c", 5, m);
+    ok &= !HexPattern::Compile("??*?", 4, m);
+    ok &= !HexPattern::Compile("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0", 65, m);
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
@@ -0,0 +1,142 @@
+// Test case for the key range scheduler (work stealing and coverage)
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include <pthread.h>
+#include <unistd.h>
+#include "KeyScheduler.h"
+
+#define NB_WORKER 8
+#define NB_CHUNK 20000  // Not a multiple of KEY_BLOCK_CHUNKS
+
+typedef struct {
+
+    KeyScheduler *s;
+    int id;
+    std::atomic<int> *walked;
+
+} WORKER;
+
+static void *work(void *p) {
+
+    WORKER *w = (WORKER *)p;
+    uint64_t start, end;
+    while (w->s->Get(w->id, start, end)) {
+        uint64_t c = start;
+        do {
+            w->walked[c]++;
+            // Worker 0 is slow, its ranges are stolen
+            if (w->id == 0) usleep(200);
+        } while (w->s->Next(w->id, c));
+        w->s->Done(start, c);
+    }
+    return NULL;
+
+}
+
+// Every chunk is walked and recorded, none is walked more than twice
+static bool test_steal() {
+
+    KeyScheduler s;
+    s.Init(NB_CHUNK, NB_WORKER, 0);
+    std::atomic<int> *walked = new std::atomic<int>[NB_CHUNK];
+    for (int i = 0; i < NB_CHUNK; i++)
+        walked[i].store(0);
+
+    pthread_t th[NB_WORKER];
+    WORKER w[NB_WORKER];
+    for (int i = 0; i < NB_WORKER; i++) {
+        w[i].s = &s;
+        w[i].id = i;
+        w[i].walked = walked;
+        pthread_create(&th[i], NULL, &work, (void *)(w + i));
+    }
+    for (int i = 0; i < NB_WORKER; i++)
+        pthread_join(th[i], NULL);
+
+    int missing = 0;
+    int twice = 0;
+    bool ok = true;
+    for (int i = 0; i < NB_CHUNK; i++) {
+        if (walked[i] == 0) missing++;
+        if (walked[i] > 1) twice++;
+        ok &= walked[i] <= 2;
+    }
+    std::vector<KEY_RANGE> done = s.GetCompleted();
+    ok &= missing == 0 && done.size() == 1 && done[0].start == 0 && done[0].end == NB_CHUNK;
+    ok &= s.GetContiguous() == NB_CHUNK && s.GetNbCompleted() == NB_CHUNK;
+    std::cout << "  " << NB_CHUNK << " chunks, " << missing << " missing, " << twice << " walked twice, "
+              << done.size() << " range(s)" << (ok ? "" : " FAIL") << std::endl;
+    delete[] walked;
+    return ok;
+
+}
+
+// Blocks are disjoint, the last one is cut at the end of the keyspace
+static bool test_blocks() {
+
+    KeyScheduler s;
+    s.Init(3 * KEY_BLOCK_CHUNKS + 5, 0, 0);
+    uint64_t b[4];
+    bool ok = s.GetBlocks(b, 2) == 2 && b[0] == 0 && b[1] == KEY_BLOCK_CHUNKS;
+    ok &= s.GetBlocks(b, 4) == 2 && b[0] == 2 * KEY_BLOCK_CHUNKS && b[1] == 3 * KEY_BLOCK_CHUNKS;
+    ok &= s.GetBlocks(b, 1) == 0;
+
+    // Out of order completion, merged ranges
+    s.Done(2 * KEY_BLOCK_CHUNKS, 3 * KEY_BLOCK_CHUNKS);
+    s.Done(3 * KEY_BLOCK_CHUNKS, 4 * KEY_BLOCK_CHUNKS);
+    ok &= s.GetContiguous() == 0 && s.GetNbCompleted() == KEY_BLOCK_CHUNKS + 5;
+    s.Done(0, 10);
+    s.Done(5, KEY_BLOCK_CHUNKS);
+    ok &= s.GetCompleted().size() == 2 && s.GetContiguous() == KEY_BLOCK_CHUNKS;
+    s.Done(KEY_BLOCK_CHUNKS, 2 * KEY_BLOCK_CHUNKS);
+    ok &= s.GetCompleted().size() == 1 && s.GetContiguous() == 3 * KEY_BLOCK_CHUNKS + 5;
+    std::cout << "  blocks and merge" << (ok ? "" : " FAIL") << std::endl;
+    return ok;
+
+}
+
+// Gaps of a restored run are handed out first, then the next blocks
+static bool test_restore() {
+
+    KeyScheduler s;
+    s.Init(KEY_UNBOUNDED, 1, 1);
+    std::vector<KEY_RANGE> done;
+    done.push_back({ 0, 100 });
+    done.push_back({ 200, KEY_BLOCK_CHUNKS + 10 });
+    s.Restore(done);
+
+    // Gaps: [100,200) then the end of block 1
+    uint64_t start, end, c;
+    bool ok = s.Get(0, start, end) && start == 100 && end == 200;
+    c = start;
+    ok &= s.Next(0, c) && s.Next(0, c);
+    std::vector<KEY_RANGE> ck = s.GetCheckpoint();
+    ok &= ck.size() == 2 && ck[0].start == 0 && ck[0].end == 102 && ck[1].start == 200;
+
+    uint64_t b[2];
+    ok &= s.GetBlocks(b, 2) == 2 && b[0] == KEY_BLOCK_CHUNKS + 10 && b[1] == 2 * KEY_BLOCK_CHUNKS;
+    s.SetBlocks(0, b, 2);
+    s.SetWalked(0, 5);
+    ck = s.GetCheckpoint();
+    ok &= ck.size() == 3 && ck[1].start == 200 && ck[1].end == KEY_BLOCK_CHUNKS + 15 &&
+          ck[2].start == 2 * KEY_BLOCK_CHUNKS && ck[2].end == 2 * KEY_BLOCK_CHUNKS + 5;
+    std::cout << "  restore and checkpoint" << (ok ? "" : " FAIL") << std::endl;
+    return ok;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing KeyScheduler ===" << std::endl;
+
+    bool ok = true;
+    ok &= test_blocks();
+    ok &= test_steal();
+    ok &= test_restore();
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
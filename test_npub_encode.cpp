@@ -0,0 +1,98 @@
+// Test and benchmark of the table driven npub encoder
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include "Bech32.h"
+#include "Timer.h"
+
+static void randomX(uint8_t *x, int size) {
+
+    for (int i = 0; i < size; i++)
+        x[i] = (uint8_t)(rand() & 0xFF);
+
+}
+
+// Same output as the generic bech32 encoder, single and batch (odd sizes included)
+static bool test_equal() {
+
+    uint8_t x[11][32];
+    char ref[128];
+    char out[11][NPUB_LENGTH + 1];
+    for (int i = 0; i < 20000; i++) {
+        int n = 1 + rand() % 11;
+        for (int k = 0; k < n; k++) {
+            randomX(x[k], 32);
+            if (rand() % 8 == 0) memset(x[k], rand() % 2 ? 0x00 : 0xFF, rand() % 32);
+        }
+        char *o[11];
+        const uint8_t *px[11];
+        for (int k = 0; k < n; k++) {
+            o[k] = out[k];
+            px[k] = x[k];
+        }
+        npub_encode_batch(o, px, n);
+        for (int k = 0; k < n; k++) {
+            bech32_encode_data(ref, "npub", x[k], 32);
+            if (strcmp(ref, out[k]) != 0) {
+                std::cout << "  FAIL batch: " << out[k] << " != " << ref << std::endl;
+                return false;
+            }
+        }
+        npub_encode(out[0], x[0]);
+        bech32_encode_data(ref, "npub", x[0], 32);
+        if (strcmp(ref, out[0]) != 0) {
+            std::cout << "  FAIL single: " << out[0] << " != " << ref << std::endl;
+            return false;
+        }
+    }
+    std::cout << "  npub encoding: OK" << std::endl;
+    return true;
+
+}
+
+static void bench() {
+
+    const int nbKey = 1024;
+    const int nbLoop = 500;
+    uint8_t *x = new uint8_t[nbKey * 32];
+    randomX(x, nbKey * 32);
+    char out[4][NPUB_LENGTH + 1];
+    size_t check = 0;
+
+    double t0 = Timer::get_tick();
+    for (int l = 0; l < nbLoop; l++)
+        for (int i = 0; i < nbKey; i++) {
+            bech32_encode_data(out[0], "npub", x + i * 32, 32);
+            check += out[0][10];
+        }
+    double t1 = Timer::get_tick();
+    for (int l = 0; l < nbLoop; l++)
+        for (int i = 0; i < nbKey; i += 4) {
+            char *o[4] = { out[0], out[1], out[2], out[3] };
+            const uint8_t *px[4] = { x + i * 32, x + (i + 1) * 32, x + (i + 2) * 32, x + (i + 3) * 32 };
+            npub_encode_batch(o, px, 4);
+            check += out[0][10] + out[3][10];
+        }
+    double t2 = Timer::get_tick();
+
+    double n = (double)nbKey * nbLoop;
+    printf("  npub: generic %.1f ns, batch %.1f ns (x%.1f) [%zu]\n",
+           (t1 - t0) * 1e9 / n, (t2 - t1) * 1e9 / n, (t1 - t0) / (t2 - t1), check);
+    delete[] x;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing npub encoder ===" << std::endl;
+    srand(12345);
+    Timer::Init();
+
+    bool ok = test_equal();
+    bench();
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
@@ -0,0 +1,101 @@
+// Test case for the multi pattern wildcard automaton
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "PatternAutomaton.h"
+#include "Wildcard.h"
+
+static const char *alphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+static std::string randomString(int length) {
+
+    std::string s = "1";
+    for (int i = 1; i < length; i++)
+        s.push_back(alphabet[rand() % 58]);
+    return s;
+
+}
+
+// Patterns matched through the automaton, confirmed by Wildcard::match
+static std::vector<int> walk(PatternAutomaton &a, const std::vector<std::string> &patterns,
+                             const std::string &addr, bool caseSensitive) {
+
+    std::vector<int> found;
+    int32_t state = 0;
+    size_t pos = 0;
+    while (state >= 0) {
+        int nb;
+        const int32_t *acc = a.Accept(state, &nb);
+        for (int j = 0; j < nb; j++)
+            if (Wildcard::match(addr.c_str(), patterns[acc[j]].c_str(), caseSensitive))
+                found.push_back(acc[j]);
+        if (a.Done(state) || pos == addr.length())
+            break;
+        state = a.Next(state, addr[pos++]);
+    }
+    return found;
+
+}
+
+static bool test_set(int nbPattern, bool caseSensitive) {
+
+    // Short random heads so that random addresses hit them
+    std::vector<std::string> patterns;
+    for (int i = 0; i < nbPattern; i++) {
+        std::string p = randomString(2 + rand() % 2);
+        if (rand() % 3 == 0) p[1 + rand() % (p.length() - 1)] = '?';
+        switch (rand() % 4) {
+        case 0: p += "*"; break;
+        case 1: p += "*" + std::string(1, alphabet[rand() % 58]); break;
+        case 2: p += "?*"; break;
+        default: p = "1*" + p.substr(1, 1); break;
+        }
+        patterns.push_back(p);
+    }
+
+    PatternAutomaton a;
+    if (!a.Compile(patterns, alphabet, caseSensitive)) {
+        std::cout << "  FAIL compile" << std::endl;
+        return false;
+    }
+
+    int nbHit = 0;
+    for (int i = 0; i < 20000; i++) {
+        std::string addr = randomString(34);
+        std::vector<int> found = walk(a, patterns, addr, caseSensitive);
+        std::vector<int> ref;
+        for (int j = 0; j < nbPattern; j++)
+            if (Wildcard::match(addr.c_str(), patterns[j].c_str(), caseSensitive))
+                ref.push_back(j);
+        std::sort(found.begin(), found.end());
+        if (found != ref) {
+            std::cout << "  FAIL " << addr << ": " << found.size() << " != " << ref.size() << std::endl;
+            return false;
+        }
+        nbHit += (int)ref.size();
+    }
+
+    std::cout << "  " << nbPattern << " patterns" << (caseSensitive ? "" : " (case unsensitive)") << ": "
+              << a.GetNbState() << " states, " << nbHit << " hits" << std::endl;
+    return true;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing PatternAutomaton ===" << std::endl;
+    srand(12345);
+
+    bool ok = true;
+    ok &= test_set(1, true);
+    ok &= test_set(10, true);
+    ok &= test_set(300, true);
+    ok &= test_set(300, false);
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
@@ -0,0 +1,98 @@
+// Test case for the lock-free result queue and its writer thread
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <cstring>
+#include <cstdio>
+#include <pthread.h>
+#include "ResultWriter.h"
+
+#define NB_PRODUCER 8
+#define NB_RESULT 20000  // Per producer, more than the ring size
+
+typedef struct {
+
+    ResultWriter *w;
+    int id;
+
+} PRODUCER;
+
+static void *produce(void *p) {
+
+    PRODUCER *pr = (PRODUCER *)p;
+    char text[RESULT_MAX_LENGTH];
+    for (int i = 0; i < NB_RESULT; i++) {
+        snprintf(text, sizeof(text), "PubAddress: %d-%d\nPriv (HEX): 0x%08X\n", pr->id, i, i);
+        pr->w->Push(text);
+    }
+    return NULL;
+
+}
+
+// Every pushed result is written once and whole
+static bool test_producers(const char *fileName, int syncCount) {
+
+    remove(fileName);
+    ResultWriter w(fileName, 1, syncCount);
+    w.Start();
+
+    pthread_t th[NB_PRODUCER];
+    PRODUCER pr[NB_PRODUCER];
+    for (int i = 0; i < NB_PRODUCER; i++) {
+        pr[i].w = &w;
+        pr[i].id = i;
+        pthread_create(&th[i], NULL, &produce, (void *)(pr + i));
+    }
+    for (int i = 0; i < NB_PRODUCER; i++)
+        pthread_join(th[i], NULL);
+    w.Stop();
+
+    FILE *f = fopen(fileName, "r");
+    if (f == NULL) {
+        std::cout << "  FAIL cannot open " << fileName << std::endl;
+        return false;
+    }
+
+    std::set<std::string> seen;
+    std::vector<int> last(NB_PRODUCER, -1);
+    char l1[RESULT_MAX_LENGTH];
+    char l2[RESULT_MAX_LENGTH];
+    bool ok = true;
+    while (ok && fgets(l1, sizeof(l1), f)) {
+        int id, i;
+        unsigned int v;
+        ok = sscanf(l1, "PubAddress: %d-%d", &id, &i) == 2 && fgets(l2, sizeof(l2), f) &&
+             sscanf(l2, "Priv (HEX): 0x%X", &v) == 1 && (int)v == i && id >= 0 && id < NB_PRODUCER &&
+             i > last[id] && seen.insert(std::string(l1)).second;
+        if (ok) last[id] = i;
+    }
+    fclose(f);
+    remove(fileName);
+
+    ok &= seen.size() == NB_PRODUCER * NB_RESULT;
+    std::cout << "  " << seen.size() << " results (sync every " << syncCount << ")" << (ok ? "" : " FAIL")
+              << std::endl;
+    return ok;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing ResultWriter ===" << std::endl;
+
+    bool ok = true;
+    ok &= test_producers("test_result_writer.txt", 64);
+    ok &= test_producers("test_result_writer.txt", 0);
+
+    // Stop without result and twice
+    ResultWriter w("test_result_writer.txt", 1, 64);
+    w.Start();
+    w.Stop();
+    w.Stop();
+    remove("test_result_writer.txt");
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}
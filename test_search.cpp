@@ -0,0 +1,268 @@
+// End to end test of the CPU search, run ./VanitySearch on a small keyspace
+// and compare its results with a brute force walk of the same keys
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <set>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <strings.h>
+#include "SECP256k1.h"
+#include "Wildcard.h"
+
+#define KEYSPACE_END 0x10000  // -keyspace 1:10000, end excluded
+
+#define MATCH_PREFIX  0
+#define MATCH_NOCASE  1
+#define MATCH_PATTERN 2
+
+typedef struct {
+
+  const char *prefix;
+  int type;
+  int match;
+  const char *options;
+
+} SEARCH_CASE;
+
+static const SEARCH_CASE cases[] = {
+  { "1Ka",   P2PKH,  MATCH_PREFIX, "" },
+  { "1Ka",   P2PKH,  MATCH_PREFIX, "-nosse" },
+  { "3Qa",   P2SH,   MATCH_PREFIX, "" },
+  { "35k",   P2SH,   MATCH_PREFIX, "" },  // bech32 characters only, not an npub
+  { "bc1qa", BECH32, MATCH_PREFIX, "" },
+  { "1kaZ",  P2PKH,  MATCH_NOCASE, "" },
+  { "3qA",   P2SH,   MATCH_NOCASE, "-nosse" },
+  { "1a?*",  P2PKH,  MATCH_PATTERN, "" },
+  { "1a?*",  P2PKH,  MATCH_PATTERN, "-nosse" },
+  { "1K*zz", P2PKH,  MATCH_PATTERN, "" },
+  { "3?b*",  P2SH,   MATCH_PATTERN, "" },
+  { "1*",    P2PKH,  MATCH_PATTERN, "" },  // Fills the hit queue
+  { "11*",   P2PKH,  MATCH_PATTERN, "" },
+  { "11*",   P2PKH,  MATCH_PATTERN, "-nosse" },
+  { "1Ab*",  P2PKH,  MATCH_PATTERN, "" },
+  { "1*Ab",  P2PKH,  MATCH_PATTERN, "" },
+  { "bc1q?a*",  BECH32, MATCH_PATTERN, "" },
+  { "bc1q?a*",  BECH32, MATCH_PATTERN, "-nosse" },
+  { "bc1qz*m",  BECH32, MATCH_PATTERN, "" },
+};
+
+// Compressed addresses of the keys 1 to KEYSPACE_END-1 with their opposite
+// and endomorphism keys, the ones the search checks
+static std::vector<std::string> allAddresses[3];
+
+static void computeAddresses(Secp256K1 &secp, int type) {
+
+  if (!allAddresses[type].empty())
+    return;
+
+  Int beta;
+  Int beta2;
+  beta.SetBase16("7ae96a2b657c07106e64479eac3434e99cf0497512f58995c1396c28719501ee");
+  beta2.SetBase16("851695d49a83f8ef919bb86153cbcb16630fb68aed0a766a3ec693d68e6afa40");
+
+  for (uint64_t i = 1; i < KEYSPACE_END; i++) {
+    Int k;
+    k.SetInt32((uint32_t)i);
+    Point p = secp.ComputePublicKey(&k);
+    for (int e = 0; e < 3; e++) {
+      Point q = p;
+      if (e == 1) q.x.ModMulK1(&beta);
+      if (e == 2) q.x.ModMulK1(&beta2);
+      allAddresses[type].push_back(secp.GetAddress(type, true, q));
+      q.y.ModNeg();
+      allAddresses[type].push_back(secp.GetAddress(type, true, q));
+    }
+  }
+
+}
+
+static bool matches(const SEARCH_CASE &c, const std::string &addr) {
+
+  size_t l = strlen(c.prefix);
+  switch (c.match) {
+  case MATCH_PREFIX:
+    return strncmp(addr.c_str(), c.prefix, l) == 0;
+  case MATCH_NOCASE:
+    return strncasecmp(addr.c_str(), c.prefix, l) == 0;
+  default:
+    return Wildcard::match(addr.c_str(), c.prefix, true);
+  }
+
+}
+
+static bool test_search(Secp256K1 &secp, const SEARCH_CASE &c) {
+
+  const char *outFile = "/tmp/vs_test_search.txt";
+  remove(outFile);
+
+  // Patterns are quoted for the shell
+  char cmd[512];
+  snprintf(cmd, sizeof(cmd), "./VanitySearch -t 2 -grp 1024 -keyspace 1:%X %s %s-o %s \"%s\" > /dev/null 2>&1",
+           KEYSPACE_END, c.options, (c.match == MATCH_NOCASE) ? "-c " : "", outFile, c.prefix);
+  if (system(cmd) != 0) {
+    std::cout << "  FAIL " << c.prefix << " " << c.options << ": search failed" << std::endl;
+    return false;
+  }
+
+  // Results, each key must give its address
+  std::set<std::string> found;
+  std::ifstream in(outFile);
+  std::string line;
+  std::string addr;
+  bool ok = true;
+  while (std::getline(in, line)) {
+    if (line.rfind("PubAddress: ", 0) == 0) {
+      addr = line.substr(12);
+      found.insert(addr);
+    } else if (line.rfind("Priv (HEX): 0x", 0) == 0) {
+      Int k;
+      k.SetBase16((char *)line.substr(14).c_str());
+      Point p = secp.ComputePublicKey(&k);
+      if (secp.GetAddress(c.type, true, p) != addr) {
+        std::cout << "  FAIL " << c.prefix << " " << c.options << ": wrong key for " << addr << std::endl;
+        ok = false;
+      }
+    }
+  }
+  remove(outFile);
+
+  computeAddresses(secp, c.type);
+  std::set<std::string> expected;
+  for (size_t i = 0; i < allAddresses[c.type].size(); i++)
+    if (matches(c, allAddresses[c.type][i]))
+      expected.insert(allAddresses[c.type][i]);
+
+  if (expected.empty() || found != expected) {
+    std::cout << "  FAIL " << c.prefix << " " << c.options << ": " << found.size() << " hits, "
+              << expected.size() << " expected" << std::endl;
+    ok = false;
+  }
+
+  std::cout << "  " << c.prefix << " " << c.options << ": " << found.size() << " hits "
+            << (ok ? "ok" : "wrong") << std::endl;
+  return ok;
+
+}
+
+// A case unsensitive base58 prefix is compiled to intervals as a whole, the
+// 2^22 spellings of this one are not enumerated
+static bool test_no_expansion() {
+
+  const char *logFile = "/tmp/vs_test_search.log";
+  char cmd[512];
+  snprintf(cmd, sizeof(cmd), "timeout 60 ./VanitySearch -t 2 -grp 1024 -keyspace 1:%X -c 1kakakakakakakakakakakak > %s 2>&1",
+           KEYSPACE_END, logFile);
+  bool ok = (system(cmd) == 0);
+
+  std::ifstream in(logFile);
+  std::string line;
+  bool started = false;
+  while (std::getline(in, line))
+    started |= (line.rfind("Search: 1kakakakakakakakakakakak [", 0) == 0);
+  remove(logFile);
+
+  ok &= started;
+  std::cout << "  case unsensitive prefix not expanded: " << (ok ? "ok" : "wrong") << std::endl;
+  return ok;
+
+}
+
+// Each check instance (search kind, address mode, SSE use) gives the same
+// results as the scalar one. -lz and -ix have a scalar instance only.
+static const char *instances[] = {
+  "1Ka", "-u 1Ka", "-b 1Ka",
+  "\"1a?*\"", "-u \"1a?*\"", "-b \"1a?*\"",
+  "bc1qa", "\"bc1q?a*\"",
+  "npub1qq", "\"npub1q?q*\"",
+  "-hex \"00*\"",
+};
+
+static bool readResults(const char *args, const char *options, std::set<std::string> &results) {
+
+  const char *outFile = "/tmp/vs_test_search.txt";
+  remove(outFile);
+
+  char cmd[512];
+  snprintf(cmd, sizeof(cmd), "./VanitySearch -t 2 -grp 1024 -keyspace 1:%X %s -o %s %s > /dev/null 2>&1",
+           KEYSPACE_END, options, outFile, args);
+  if (system(cmd) != 0)
+    return false;
+
+  // Address and key pairs
+  std::ifstream in(outFile);
+  std::string line;
+  std::string addr;
+  while (std::getline(in, line)) {
+    if (line.rfind("PubAddress: ", 0) == 0)
+      addr = line.substr(12);
+    else if (line.rfind("Priv (HEX): ", 0) == 0)
+      results.insert(addr + " " + line.substr(12));
+  }
+  remove(outFile);
+  return true;
+
+}
+
+static bool test_instances() {
+
+  bool ok = true;
+  for (int i = 0; i < (int)(sizeof(instances) / sizeof(instances[0])); i++) {
+    std::set<std::string> sse;
+    std::set<std::string> scalar;
+    bool iok = readResults(instances[i], "", sse) && readResults(instances[i], "-nosse", scalar);
+    iok &= !scalar.empty() && sse == scalar;
+    std::cout << "  " << instances[i] << ": " << sse.size() << " SSE hits, " << scalar.size() << " scalar hits "
+              << (iok ? "ok" : "wrong") << std::endl;
+    ok &= iok;
+  }
+  return ok;
+
+}
+
+// Options taking a value may come last, the value is not a prefix
+static bool test_option_order() {
+
+  const char *outFile = "/tmp/vs_test_search.txt";
+  remove(outFile);
+
+  char cmd[512];
+  snprintf(cmd, sizeof(cmd), "./VanitySearch -t 2 -grp 1024 -keyspace 1:%X -lz 16 -o %s > /dev/null 2>&1",
+           KEYSPACE_END, outFile);
+  bool ok = (system(cmd) == 0);
+
+  std::ifstream in(outFile);
+  std::string line;
+  bool found = false;
+  while (std::getline(in, line))
+    found |= (line.rfind("Priv (HEX): ", 0) == 0);
+  remove(outFile);
+
+  ok &= found;
+  std::cout << "  -lz 16 -o file: " << (ok ? "ok" : "wrong") << std::endl;
+  return ok;
+
+}
+
+int main() {
+
+  std::cout << "=== Testing the CPU search on keyspace 1:" << std::hex << KEYSPACE_END << std::dec << " ===" << std::endl;
+
+  Secp256K1 *secp = new Secp256K1();
+  secp->Init();
+
+  bool ok = true;
+  for (int i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++)
+    ok &= test_search(*secp, cases[i]);
+  ok &= test_no_expansion();
+  ok &= test_instances();
+  ok &= test_option_order();
+
+  delete secp;
+
+  std::cout << (ok ? "OK" : "Failed !") << std::endl;
+  return ok ? 0 : 1;
+
+}
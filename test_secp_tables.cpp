@@ -0,0 +1,115 @@
+// Test case for the field constants and the generator table
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include "SECP256k1.h"
+
+// Reference values computed with an independent big integer implementation
+static const char *refR[4] = {
+    "1000003D1",                          // R   = 2^256 mod p
+    "1000007A2000E90A1",                  // R^2 mod p
+    "100000B73002BB1E33795F671",          // R^3 mod p
+    "100000F44005763C6DE57DA9823518541"   // R^4 mod p
+};
+
+// k.G, keys b.256^i read a single table entry GTable[256.i + b - 1]
+static const char *refPoints[][3] = {
+    { "1", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8" },
+    { "2", "C6047F9441ED7D6D3045406E95C07CD85C778E4B8CEF3CA7ABAC09B95C709EE5", "1AE168FEA63DC339A3C58419466CEAEEF7F632653266D0E1236431A950CFE52A" },
+    { "FF", "1B38903A43F7F114ED4500B4EAC7083FDEFECE1CF29C63528D563446F972C180", "4036EDC931A60AE889353F77FD53DE4A2708B26B6F5DA72AD3394119DAF408F9" },
+    { "100", "8282263212C609D9EA2A6E3E172DE238D8C39CABD5AC1CA10646E23FD5F51508", "11F8A8098557DFE45E8256E830B60ACE62D613AC2F7B17BED31B6EAFF6E26CAF" },
+    { "8000", "4A4A6DC97AC7C8B8AD795DBEBCB9DCFF7290B68A5EF74E56AB5EDDE01BCED775", "529911B016631E72943EF9F739C0F4571DE90CDB424742ACB2BF8F68A78DD66D" },
+    { "4D000000000000000000000000000000", "11D98074924B315F02F97392307B0EC30F11CBD0D6FF372ADEF363DFC6AC2B91", "A1B42EC52586433DEB1DE101529CD2D5DFA20EA9515C0401388C9D8002760309" },
+    { "FF00000000000000000000000000000000000000000000000000000000000000", "85C9BD8AD859CDB136A95FC386B552FB9FCE855D6CDDDAD6AA62F800390E1B15", "CE24648EAD89FDD58F9855C07DE6CDEEE45EDF47DE0B8FB83F5C1E9C59A6C8C4" },
+    { "A1B2C3D4E5F60718293A4B5C6D7E8F90112233445566778899AABBCCDDEEFF0", "C9DB22193C4FE5CA28B7D6457AF024F8A07C833A35EB1EDEEA604E1F46172EC4", "782DC6F3D48947423CF7C7D8D0F7B66C254C9DA720ADFC3E6FFFCE4D0F41ADCC" },
+};
+
+static bool test_field() {
+
+    Int *R[4] = { Int::GetR(), Int::GetR2(), Int::GetR3(), Int::GetR4() };
+    bool ok = true;
+    for (int i = 0; i < 4; i++) {
+        Int ref;
+        ref.SetBase16((char *)refR[i]);
+        if (!R[i]->IsEqual(&ref)) {
+            std::cout << "  FAIL R^" << (i + 1) << " = " << R[i]->GetBase16() << " expected " << refR[i] << std::endl;
+            ok = false;
+        }
+    }
+
+    // Montgomery products agree with the plain modular product
+    Int a;
+    Int b;
+    a.SetBase16("3B6A27BCCEB6A42D62A3A8D02A6F0D73653215771DE243A63AC048A18B59DA29");
+    b.SetBase16("C9DB22193C4FE5CA28B7D6457AF024F8A07C833A35EB1EDEEA604E1F46172EC4");
+    Int m1;
+    Int m2;
+    m1.ModMulK1(&a, &b);
+    m2.ModMul(&a, &b);
+    if (!m1.IsEqual(&m2)) {
+        std::cout << "  FAIL ModMul " << m2.GetBase16() << " ModMulK1 " << m1.GetBase16() << std::endl;
+        ok = false;
+    }
+
+    std::cout << "  field constants: " << (ok ? "ok" : "wrong") << std::endl;
+    return ok;
+
+}
+
+static bool test_table(Secp256K1 &secp, const char *name) {
+
+    bool ok = true;
+    for (int i = 0; i < (int)(sizeof(refPoints) / sizeof(refPoints[0])); i++) {
+        Int k;
+        k.SetBase16((char *)refPoints[i][0]);
+        Point p = secp.ComputePublicKey(&k);
+        Int x;
+        Int y;
+        x.SetBase16((char *)refPoints[i][1]);
+        y.SetBase16((char *)refPoints[i][2]);
+        if (!p.x.IsEqual(&x) || !p.y.IsEqual(&y)) {
+            std::cout << "  FAIL " << name << " " << refPoints[i][0] << ".G = " << p.x.GetBase16() << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << "  " << name << " table: " << (ok ? "ok" : "wrong") << std::endl;
+    return ok;
+
+}
+
+int main() {
+
+    std::cout << "=== Testing field constants and generator table ===" << std::endl;
+
+    // Table built from scratch, then reloaded from the cache it writes
+    char cacheFile[] = "/tmp/vs_test_gtable.bin";
+    remove(cacheFile);
+    setenv("VS_K1_CACHE", cacheFile, 1);
+
+    bool ok = true;
+    Secp256K1 *built = new Secp256K1();
+    built->Init();
+    ok &= test_field();
+    ok &= test_table(*built, "computed");
+    delete built;
+
+    Secp256K1 *cached = new Secp256K1();
+    cached->Init();
+    ok &= test_table(*cached, "cached");
+    delete cached;
+    remove(cacheFile);
+
+    // Table shipped with the sources
+    setenv("VS_K1_CACHE", "k1_gtable.v1.bin", 1);
+    Secp256K1 *shipped = new Secp256K1();
+    shipped->Init();
+    ok &= test_table(*shipped, "k1_gtable.v1.bin");
+    delete shipped;
+
+    std::cout << (ok ? "OK" : "Failed !") << std::endl;
+    return ok ? 0 : 1;
+
+}